@@ -297,6 +297,10 @@ QMAKE_SUBSTITUTES += CutterConfig.h.in
 SOURCES += \
     plugins/ppCutter/core/PPCutterCore.cpp \
     plugins/ppCutter/core/PPBinaryFile.cpp \
+    plugins/ppCutter/core/PPTask.cpp \
+    plugins/ppCutter/core/PPBatch.cpp \
+    plugins/ppCutter/core/PPBinaryProject.cpp \
+    plugins/ppCutter/core/PPAnnotationStore.cpp \
     plugins/ppCutter/widgets/AnnotationsEditorWidget.cpp \
     plugins/ppCutter/widgets/AnnotationsEditorDockWidget.cpp \
     plugins/ppCutter/models/PPAnnotationDataModel.cpp \
@@ -387,6 +391,8 @@ SOURCES += \
     widgets/BacktraceWidget.cpp \
     dialogs/MapFileDialog.cpp \
     common/CommandTask.cpp \
+    common/StringsTask.cpp \
+    common/HashTask.cpp \
     common/ProgressIndicator.cpp \
     common/R2Task.cpp \
     dialogs/R2TaskDialog.cpp \
@@ -455,6 +461,10 @@ GRAPHVIZ_SOURCES = \
 HEADERS  += \
     plugins/ppCutter/core/PPCutterCore.h \
     plugins/ppCutter/core/PPBinaryFile.h \
+    plugins/ppCutter/core/PPTask.h \
+    plugins/ppCutter/core/PPBatch.h \
+    plugins/ppCutter/core/PPBinaryProject.h \
+    plugins/ppCutter/core/PPAnnotationStore.h \
     plugins/ppCutter/widgets/AnnotationsEditorWidget.h \
     plugins/ppCutter/widgets/AnnotationsEditorDockWidget.h \
     plugins/ppCutter/models/PPAnnotationDataModel.h \
@@ -547,6 +557,7 @@ HEADERS  += \
     widgets/BacktraceWidget.h \
     dialogs/MapFileDialog.h \
     common/StringsTask.h \
+    common/HashTask.h \
     common/FunctionsTask.h \
     common/CommandTask.h \
     common/ProgressIndicator.h \
@@ -5,6 +5,7 @@
 #include "CutterConfig.h"
 #include "common/Decompiler.h"
 #include "common/ResourcePaths.h"
+#include "plugins/ppCutter/core/PPBatch.h"
 
 #include <QApplication>
 #include <QFileOpenEvent>
@@ -197,6 +198,74 @@ CutterApplication::~CutterApplication()
 #endif
 }
 
+int CutterApplication::runPPBatch(int &argc, char **argv)
+{
+    // Keep this function in sync with documentation
+
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser cmd_parser;
+    cmd_parser.setApplicationDescription(
+        QObject::tr("Post-process ELF files with pp: apply an annotation project, disassemble, "
+                    "calculate states and write the patched files."));
+    cmd_parser.addHelpOption();
+    cmd_parser.addPositionalArgument("filenames", QObject::tr("ELF files to process."),
+                                     QObject::tr("files..."));
+
+    QCommandLineOption ppBatchOption("pp-batch", QObject::tr("Run in pp batch mode."));
+    cmd_parser.addOption(ppBatchOption);
+
+    QCommandLineOption projectOption({"p", "project"},
+                                     QObject::tr("Annotation project to apply to every file"),
+                                     QObject::tr("file"));
+    cmd_parser.addOption(projectOption);
+
+    QCommandLineOption outputOption({"o", "output"},
+                                    QObject::tr("Directory for the patched files. "
+                                                "By default <file>.pp is written next to each input."),
+                                    QObject::tr("directory"));
+    cmd_parser.addOption(outputOption);
+
+    QCommandLineOption jobsOption({"j", "jobs"},
+                                  QObject::tr("Number of files processed in parallel, "
+                                              "defaults to the number of cores"),
+                                  QObject::tr("count"));
+    cmd_parser.addOption(jobsOption);
+
+    QCommandLineOption convertOption("convert-project",
+                                     QObject::tr("Convert the project given with -p into the binary "
+                                                 "project format for the single input file "
+                                                 "instead of patching it"),
+                                     QObject::tr("file"));
+    cmd_parser.addOption(convertOption);
+
+    cmd_parser.process(app);
+
+    PPBatchOptions options;
+    options.inputFiles = cmd_parser.positionalArguments();
+    options.projectFile = cmd_parser.value(projectOption);
+    options.outputDir = cmd_parser.value(outputOption);
+    options.convertOutput = cmd_parser.value(convertOption);
+
+    if (options.inputFiles.isEmpty()) {
+        fprintf(stderr, "%s\n",
+                QObject::tr("At least one file must be specified.").toLocal8Bit().constData());
+        return 1;
+    }
+
+    if (cmd_parser.isSet(jobsOption)) {
+        bool ok = false;
+        options.jobs = cmd_parser.value(jobsOption).toInt(&ok);
+        if (!ok || options.jobs < 1) {
+            fprintf(stderr, "%s\n",
+                    QObject::tr("Invalid number of jobs.").toLocal8Bit().constData());
+            return 1;
+        }
+    }
+
+    return PPBatch(options).run() == 0 ? 0 : 1;
+}
+
 void CutterApplication::launchNewInstance(const QStringList &args)
 {
     QProcess process(this);
@@ -355,8 +424,19 @@ bool CutterApplication::parseCommandLineOptions()
                                         QObject::tr("Do not load radare2 plugins"));
     cmd_parser.addOption(disableR2Plugins);
 
+    QCommandLineOption ppBatchOption("pp-batch",
+                                     QObject::tr("Post-process ELF files with pp without starting the GUI. "
+                                                 "Must be the first argument, see --pp-batch --help."));
+    cmd_parser.addOption(ppBatchOption);
+
     cmd_parser.process(*this);
 
+    if (cmd_parser.isSet(ppBatchOption)) {
+        fprintf(stderr, "%s\n",
+                QObject::tr("--pp-batch must be the first argument.").toLocal8Bit().constData());
+        return false;
+    }
+
     CutterCommandLineOptions opts;
     opts.args = cmd_parser.positionalArguments();
 
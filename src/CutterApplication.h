@@ -36,6 +36,13 @@ public:
     }
 
     void launchNewInstance(const QStringList &args = {});
+
+    /**
+     * @brief Headless pp post-processing, used instead of constructing a
+     * CutterApplication when "--pp-batch" is the first argument.
+     * @return process exit code
+     */
+    static int runPPBatch(int &argc, char **argv);
 protected:
     bool event(QEvent *e);
 
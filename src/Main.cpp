@@ -5,6 +5,7 @@
 #include "CutterConfig.h"
 #include "common/CrashHandler.h"
 #include "common/SettingsUpgrade.h"
+#include "common/StringsTask.h"
 
 #include <QJsonObject>
 #include <QJsonArray>
@@ -67,7 +68,12 @@ int main(int argc, char *argv[])
     connectToConsole();
 #endif
 
+    if (argc >= 2 && QString::fromLocal8Bit(argv[1]) == "--pp-batch") {
+        return CutterApplication::runPPBatch(argc, argv);
+    }
+
     qRegisterMetaType<QList<StringDescription>>();
+    qRegisterMetaType<QVector<ScannedString>>();
     qRegisterMetaType<QList<FunctionDescription>>();
 
     QCoreApplication::setOrganizationName("RadareOrg");
@@ -149,6 +149,9 @@ Configuration::Configuration() : QObject(), nativePalette(qApp->palette())
 #ifdef CUTTER_ENABLE_KSYNTAXHIGHLIGHTING
     kSyntaxHighlightingRepository = nullptr;
 #endif
+
+    loadColors();
+    connect(this, &Configuration::colorsUpdated, this, &Configuration::loadColors);
 }
 
 Configuration *Configuration::instance()
@@ -516,6 +519,37 @@ QString Configuration::getLogoFile()
 void Configuration::setColor(const QString &name, const QColor &color)
 {
     s.setValue("colors." + name, color);
+
+    auto it = colorIndices.constFind(name);
+    if (it != colorIndices.constEnd()) {
+        colorTable[it.value()] = color;
+        return;
+    }
+    int index = colorTable.size();
+    colorIndices.insert(name, index);
+    colorTable.append(color);
+    if (name == QLatin1String("other")) {
+        otherColorIndex = index;
+    }
+}
+
+/**
+ * @brief Rebuilds the color table from the settings, called whenever colorsUpdated is emitted.
+ */
+void Configuration::loadColors()
+{
+    static const QString prefix = QStringLiteral("colors.");
+
+    colorTable.clear();
+    colorIndices.clear();
+    for (const QString &key : s.allKeys()) {
+        if (!key.startsWith(prefix)) {
+            continue;
+        }
+        colorIndices.insert(key.mid(prefix.size()), colorTable.size());
+        colorTable.append(s.value(key).value<QColor>());
+    }
+    otherColorIndex = colorIndices.value(QStringLiteral("other"), -1);
 }
 
 void Configuration::setLastThemeOf(const CutterInterfaceTheme &currInterfaceTheme, const QString &theme)
@@ -525,11 +559,8 @@ void Configuration::setLastThemeOf(const CutterInterfaceTheme &currInterfaceThem
 
 const QColor Configuration::getColor(const QString &name) const
 {
-    if (s.contains("colors." + name)) {
-        return s.value("colors." + name).value<QColor>();
-    } else {
-        return s.value("colors.other").value<QColor>();
-    }
+    int index = colorIndices.value(name, otherColorIndex);
+    return index >= 0 ? colorTable[index] : QColor();
 }
 
 void Configuration::setColorTheme(const QString &theme)
@@ -586,6 +617,7 @@ void Configuration::applySavedAsmOptions()
     for (auto it = asmOptions.cbegin(); it != asmOptions.cend(); it++) {
         Core()->setConfig(it.key(), s.value(it.key(), it.value()));
     }
+    Core()->triggerAsmOptionsChanged();
 }
 
 const QList<CutterInterfaceTheme>& Configuration::cutterInterfaceThemesList()
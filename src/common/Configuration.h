@@ -43,8 +43,14 @@ private:
 #endif
     bool outputRedirectEnabled = true;
 
+    // Copy of the "colors." settings, so painting does not have to go through QSettings
+    QVector<QColor> colorTable;
+    QHash<QString, int> colorIndices;
+    int otherColorIndex = -1;
+
     Configuration();
     // Colors
+    void loadColors();
     void loadBaseThemeNative();
     void loadBaseThemeDark();
     void loadNativeStylesheet();
@@ -0,0 +1,269 @@
+#include "HashTask.h"
+
+#include <QCryptographicHash>
+#include <QtEndian>
+
+#include <array>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC32_PCLMUL
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) && defined(__aarch64__) && (defined(__ARM_FEATURE_CRC32) || defined(__linux__))
+#define CRC32_ARMV8
+#include <arm_acle.h>
+#ifdef __ARM_FEATURE_CRC32
+#define CRC32_ARMV8_TARGET
+#else
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#ifdef __clang__
+#define CRC32_ARMV8_TARGET __attribute__((target("crc")))
+#else
+#define CRC32_ARMV8_TARGET __attribute__((target("+crc")))
+#endif
+#endif
+#endif
+
+namespace {
+
+#ifdef CRC32_PCLMUL
+/**
+ * @brief Fold 16 byte blocks with carry-less multiplication, as described in Intel's "Fast CRC
+ * Computation for Generic Polynomials Using PCLMULQDQ Instruction", with the constants for the
+ * bit-reflected IEEE polynomial.
+ * @param crc CRC register before \a data, not inverted
+ * @param len at least 64 and a multiple of 16
+ */
+__attribute__((target("pclmul,sse4.1")))
+ut32 crc32Pclmul(ut32 crc, const uchar *data, size_t len)
+{
+    alignas(16) static const ut64 k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+    alignas(16) static const ut64 k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+    alignas(16) static const ut64 k5k0[] = { 0x0163cd6124, 0x0000000000 };
+    alignas(16) static const ut64 poly[] = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+    data += 64;
+    len -= 64;
+
+    // fold four blocks in parallel
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x30)));
+        data += 64;
+        len -= 64;
+    }
+
+    // fold the four blocks into one
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+    for (__m128i next : { x2, x3, x4 }) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, next), x5);
+    }
+
+    // fold the remaining single blocks
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data))),
+                           x5);
+        data += 16;
+        len -= 16;
+    }
+
+    // 128 to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return static_cast<ut32>(_mm_extract_epi32(x1, 1));
+}
+#endif
+
+#ifdef CRC32_ARMV8
+/**
+ * @brief The CRC32X/CRC32B instructions, which use the IEEE polynomial (unlike CRC32CX/CRC32CB).
+ */
+CRC32_ARMV8_TARGET
+ut32 crc32Armv8(ut32 crc, const uchar *data, size_t len)
+{
+    while (len >= 8) {
+        crc = __crc32d(crc, qFromLittleEndian<quint64>(data));
+        data += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = __crc32b(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+/**
+ * @brief CRC-32 (IEEE 802.3, as "ph crc32"). Uses PCLMULQDQ on x86 and the CRC32 instructions
+ * on ARMv8 if the CPU has them, slicing-by-8 tables otherwise.
+ */
+class Crc32
+{
+public:
+    Crc32()
+    {
+        static const Tables tables = makeTables();
+        t = &tables;
+    }
+
+    void addData(const uchar *data, size_t len)
+    {
+        ut32 c = crc;
+#ifdef CRC32_PCLMUL
+        static const bool hasPclmul = __builtin_cpu_supports("pclmul")
+                                      && __builtin_cpu_supports("sse4.1");
+        if (hasPclmul && len >= 64) {
+            size_t blocks = len & ~size_t(15);
+            c = crc32Pclmul(c, data, blocks);
+            data += blocks;
+            len -= blocks;
+        }
+#endif
+#ifdef CRC32_ARMV8
+#ifdef __ARM_FEATURE_CRC32
+        static const bool hasCrc32 = true;
+#else
+        static const bool hasCrc32 = getauxval(AT_HWCAP) & HWCAP_CRC32;
+#endif
+        if (hasCrc32) {
+            crc = crc32Armv8(c, data, len);
+            return;
+        }
+#endif
+        while (len >= 8) {
+            ut32 lo = qFromLittleEndian<quint32>(data) ^ c;
+            ut32 hi = qFromLittleEndian<quint32>(data + 4);
+            c = (*t)[7][lo & 0xff] ^ (*t)[6][(lo >> 8) & 0xff]
+                ^ (*t)[5][(lo >> 16) & 0xff] ^ (*t)[4][lo >> 24]
+                ^ (*t)[3][hi & 0xff] ^ (*t)[2][(hi >> 8) & 0xff]
+                ^ (*t)[1][(hi >> 16) & 0xff] ^ (*t)[0][hi >> 24];
+            data += 8;
+            len -= 8;
+        }
+        while (len--) {
+            c = (*t)[0][(c ^ *data++) & 0xff] ^ (c >> 8);
+        }
+        crc = c;
+    }
+
+    ut32 result() const     { return ~crc; }
+
+private:
+    using Tables = std::array<std::array<ut32, 256>, 8>;
+
+    static Tables makeTables()
+    {
+        Tables tables;
+        for (ut32 i = 0; i < 256; i++) {
+            ut32 c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (c >> 1) ^ 0xedb88320 : c >> 1;
+            }
+            tables[0][i] = c;
+        }
+        for (ut32 i = 0; i < 256; i++) {
+            for (size_t k = 1; k < tables.size(); k++) {
+                tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xff];
+            }
+        }
+        return tables;
+    }
+
+    const Tables *t;
+    ut32 crc = 0xffffffff;
+};
+
+}
+
+HashTask::HashTask(RVA address, ut64 size)
+    : address(address),
+      size(size)
+{
+}
+
+void HashTask::runTask()
+{
+    QCryptographicHash md5Hash(QCryptographicHash::Md5);
+    QCryptographicHash sha1Hash(QCryptographicHash::Sha1);
+    QCryptographicHash sha256Hash(QCryptographicHash::Sha256);
+    Crc32 crc32Hash;
+    std::array<ut64, 256> histogram {};
+
+    for (ut64 done = 0; done < size;) {
+        if (isInterrupted()) {
+            return;
+        }
+        int len = static_cast<int>(qMin<ut64>(chunkSize, size - done));
+        QByteArray chunk = Core()->ioRead(address + done, len);
+        if (chunk.size() != len) {
+            return;
+        }
+
+        md5Hash.addData(chunk);
+        sha1Hash.addData(chunk);
+        sha256Hash.addData(chunk);
+        const uchar *data = reinterpret_cast<const uchar *>(chunk.constData());
+        crc32Hash.addData(data, static_cast<size_t>(len));
+        for (int i = 0; i < len; i++) {
+            histogram[data[i]]++;
+        }
+        done += static_cast<ut64>(len);
+    }
+
+    double entropyBits = 0;
+    for (ut64 count : histogram) {
+        if (count) {
+            double p = static_cast<double>(count) / size;
+            entropyBits -= p * std::log2(p);
+        }
+    }
+
+    md5 = QString::fromLatin1(md5Hash.result().toHex());
+    sha1 = QString::fromLatin1(sha1Hash.result().toHex());
+    sha256 = QString::fromLatin1(sha256Hash.result().toHex());
+    crc32 = QString("%1").arg(crc32Hash.result(), 8, 16, QLatin1Char('0'));
+    entropy = QString::number(entropyBits, 'f', 6);
+}
@@ -0,0 +1,44 @@
+#ifndef HASHTASK_H
+#define HASHTASK_H
+
+#include "common/AsyncTask.h"
+#include "core/Cutter.h"
+
+/**
+ * @brief Calculates the digests and entropy shown for a hexdump selection.
+ *
+ * The range is read once in chunks and every chunk is fed to all hashes, instead of
+ * running a separate "ph" command for each of them.
+ */
+class HashTask : public AsyncTask
+{
+Q_OBJECT
+
+public:
+    static const int chunkSize = 1 << 20;
+
+    HashTask(RVA address, ut64 size);
+
+    QString getTitle() override                     { return tr("Calculating hashes"); }
+
+    const QString &getMd5() const                   { return md5; }
+    const QString &getSha1() const                  { return sha1; }
+    const QString &getSha256() const                { return sha256; }
+    const QString &getCrc32() const                 { return crc32; }
+    const QString &getEntropy() const               { return entropy; }
+
+protected:
+    void runTask() override;
+
+private:
+    RVA address;
+    ut64 size;
+
+    QString md5;
+    QString sha1;
+    QString sha256;
+    QString crc32;
+    QString entropy;
+};
+
+#endif // HASHTASK_H
@@ -0,0 +1,243 @@
+#include "StringsTask.h"
+
+#include <algorithm>
+
+QSharedPointer<StringsSource> StringsSource::fromCurrentFile()
+{
+    RCoreLocked core = Core()->core();
+    RBinFile *bf = core->bin ? core->bin->cur : nullptr;
+    if (!bf || !bf->o) {
+        return nullptr;
+    }
+
+    QSharedPointer<StringsSource> source(new StringsSource());
+    // bin.minstr defaults to 0, meaning r2's own minimum of 4 (the default of minLength)
+    int minLength = static_cast<int>(r_config_get_i(core->config, "bin.minstr"));
+    if (minLength > 0) {
+        source->minLength = minLength;
+    }
+
+    if (bf->file) {
+        source->file.setFileName(QString::fromUtf8(bf->file));
+        if (source->file.open(QIODevice::ReadOnly) && source->file.size() > 0) {
+            source->fileData = source->file.map(0, source->file.size());
+            source->fileSize = source->fileData ? static_cast<ut64>(source->file.size()) : 0;
+        }
+    }
+    if (!source->fileData && bf->buf) {
+        // not backed by a regular file, take a copy of what RBin has loaded; read it in
+        // chunks since it can be larger than a single read can return
+        const ut64 chunkSize = 64 * 1024 * 1024;
+        ut64 size = r_buf_size(bf->buf);
+        source->buffer.resize(size);
+        for (ut64 offset = 0; offset < size; offset += chunkSize) {
+            int count = static_cast<int>(std::min(chunkSize, size - offset));
+            r_buf_read_at(bf->buf, offset, source->buffer.data() + offset, count);
+        }
+        source->fileData = source->buffer.data();
+        source->fileSize = size;
+    }
+
+    RListIter *it;
+    RBinSection *sect;
+    CutterRListForeach(bf->o->sections, it, RBinSection, sect) {
+        if (sect->is_segment || !sect->size || source->sections.size() >= NoSection) {
+            continue;
+        }
+        source->sections.append({ QString::fromUtf8(sect->name), sect->paddr, sect->size,
+                                  sect->vaddr });
+    }
+    std::sort(source->sections.begin(), source->sections.end(),
+              [](const Section &a, const Section &b) {
+        return a.paddr < b.paddr;
+    });
+
+    return source;
+}
+
+StringsSource::~StringsSource()
+{
+    if (fileData && buffer.empty()) {
+        file.unmap(const_cast<uchar *>(fileData));
+    }
+}
+
+ut16 StringsSource::sectionAt(ut64 paddr) const
+{
+    auto it = std::upper_bound(sections.begin(), sections.end(), paddr,
+                               [](ut64 paddr, const Section &section) {
+        return paddr < section.paddr;
+    });
+    if (it == sections.begin()) {
+        return NoSection;
+    }
+    --it;
+    if (paddr - it->paddr >= it->size) {
+        return NoSection;
+    }
+    return static_cast<ut16>(it - sections.begin());
+}
+
+QString StringsSource::text(const ScannedString &str) const
+{
+    const char *data = reinterpret_cast<const char *>(fileData + str.paddr);
+    switch (str.encoding) {
+    case ScannedString::Utf16le: {
+        // only strings with a zero high byte are found, so every other byte is the character
+        QString result(static_cast<int>(str.length), Qt::Uninitialized);
+        for (ut32 i = 0; i < str.length; i++) {
+            result[i] = QChar(static_cast<uchar>(data[i * 2]));
+        }
+        return result;
+    }
+    case ScannedString::Utf8:
+        return QString::fromUtf8(data, static_cast<int>(str.size));
+    case ScannedString::Ascii:
+    default:
+        return QString::fromLatin1(data, static_cast<int>(str.size));
+    }
+}
+
+RVA StringsSource::vaddr(const ScannedString &str) const
+{
+    if (str.section == NoSection) {
+        return str.paddr;
+    }
+    const Section &section = sections[str.section];
+    return section.vaddr + (str.paddr - section.paddr);
+}
+
+QString StringsSource::section(const ScannedString &str) const
+{
+    return str.section == NoSection ? QString() : sections[str.section].name;
+}
+
+QString StringsSource::type(const ScannedString &str) const
+{
+    switch (str.encoding) {
+    case ScannedString::Utf8:
+        return QStringLiteral("utf8");
+    case ScannedString::Utf16le:
+        return QStringLiteral("utf16le");
+    case ScannedString::Ascii:
+    default:
+        return QStringLiteral("ascii");
+    }
+}
+
+StringDescription StringsSource::description(const ScannedString &str) const
+{
+    StringDescription desc;
+    desc.vaddr = vaddr(str);
+    desc.string = text(str);
+    desc.type = type(str);
+    desc.section = section(str);
+    desc.length = str.length;
+    desc.size = str.size;
+    return desc;
+}
+
+
+static inline bool isPrintable(uchar c)
+{
+    return (c >= 0x20 && c < 0x7f) || c == '\t';
+}
+
+/**
+ * @brief Length in bytes of the UTF-8 sequence at data, 0 if there is no valid multibyte sequence.
+ */
+static ut32 utf8SequenceLength(const uchar *data, ut64 available)
+{
+    uchar c = data[0];
+    ut32 len = c >= 0xc2 && c <= 0xdf ? 2 : c >= 0xe0 && c <= 0xef ? 3 : c >= 0xf0 && c <= 0xf4 ? 4 : 0;
+    if (!len || len > available) {
+        return 0;
+    }
+    for (ut32 i = 1; i < len; i++) {
+        if ((data[i] & 0xc0) != 0x80) {
+            return 0;
+        }
+    }
+    return len;
+}
+
+StringsTask::StringsTask(QSharedPointer<const StringsSource> source)
+    : source(std::move(source))
+{
+}
+
+void StringsTask::runTask()
+{
+    const uchar *data = source->data();
+    const ut64 size = source->size();
+    const ut32 minLength = static_cast<ut32>(source->getMinLength());
+
+    QVector<ScannedString> batch;
+    batch.reserve(batchSize);
+    ut64 nextChunk = chunkSize;
+
+    ut64 pos = 0;
+    while (pos < size) {
+        if (pos >= nextChunk) {
+            if (isInterrupted()) {
+                return;
+            }
+            if (!batch.isEmpty()) {
+                emit stringsFound(batch);
+                batch.clear();
+            }
+            nextChunk = pos + chunkSize;
+        }
+
+        ScannedString str;
+        str.paddr = pos;
+
+        // UTF-16LE, limited to the latin range
+        ut64 end = pos;
+        while (end + 1 < size && data[end + 1] == 0 && isPrintable(data[end])
+                && end - pos < UT32_MAX) {
+            end += 2;
+        }
+        if ((end - pos) / 2 >= minLength) {
+            str.size = static_cast<ut32>(end - pos);
+            str.length = str.size / 2;
+            str.encoding = ScannedString::Utf16le;
+        } else {
+            // ASCII, or UTF-8 as soon as there is a multibyte sequence
+            bool multibyte = false;
+            ut32 length = 0;
+            end = pos;
+            while (end < size && end - pos < UT32_MAX - 4) {
+                if (isPrintable(data[end])) {
+                    end++;
+                } else if (ut32 seqLen = utf8SequenceLength(data + end, size - end)) {
+                    end += seqLen;
+                    multibyte = true;
+                } else {
+                    break;
+                }
+                length++;
+            }
+            if (length < minLength) {
+                // a UTF-16 string may start within the short run
+                pos++;
+                continue;
+            }
+            str.size = static_cast<ut32>(end - pos);
+            str.length = length;
+            str.encoding = multibyte ? ScannedString::Utf8 : ScannedString::Ascii;
+        }
+
+        str.section = source->sectionAt(pos);
+        batch.append(str);
+        if (batch.size() >= batchSize) {
+            emit stringsFound(batch);
+            batch.clear();
+        }
+        pos += str.size;
+    }
+
+    if (!batch.isEmpty() && !isInterrupted()) {
+        emit stringsFound(batch);
+    }
+}
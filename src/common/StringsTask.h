@@ -5,22 +5,99 @@
 #include "common/AsyncTask.h"
 #include "core/Cutter.h"
 
+#include <QFile>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <vector>
+
+/**
+ * @brief String found by StringsTask. Only its location is stored, the text is decoded
+ * from the StringsSource it was found in when needed.
+ */
+struct ScannedString {
+    enum Encoding : ut8 { Ascii, Utf8, Utf16le };
+
+    ut64 paddr;
+    ut32 size;      //!< in bytes
+    ut32 length;    //!< in characters
+    ut16 section;   //!< index into the sections of the StringsSource
+    Encoding encoding;
+};
+Q_DECLARE_TYPEINFO(ScannedString, Q_PRIMITIVE_TYPE);
+Q_DECLARE_METATYPE(ScannedString)
+
+/**
+ * @brief Contents and sections of the currently opened file, mapped read-only if possible.
+ */
+class StringsSource
+{
+public:
+    static const ut16 NoSection = 0xffff;
+
+    struct Section {
+        QString name;
+        ut64 paddr;
+        ut64 size;
+        RVA vaddr;
+    };
+
+    /**
+     * @return source for the file currently loaded in RBin, nullptr if there is none
+     */
+    static QSharedPointer<StringsSource> fromCurrentFile();
+
+    StringsSource(const StringsSource &) = delete;
+    StringsSource &operator=(const StringsSource &) = delete;
+    ~StringsSource();
+
+    const uchar *data() const       { return fileData; }
+    ut64 size() const               { return fileSize; }
+    int getMinLength() const        { return minLength; }
+
+    ut16 sectionAt(ut64 paddr) const;
+
+    QString text(const ScannedString &str) const;
+    RVA vaddr(const ScannedString &str) const;
+    QString section(const ScannedString &str) const;
+    QString type(const ScannedString &str) const;
+    StringDescription description(const ScannedString &str) const;
+
+private:
+    StringsSource() = default;
+
+    QFile file;
+    std::vector<uchar> buffer; //!< copy of the file if it could not be mapped
+    const uchar *fileData = nullptr;
+    ut64 fileSize = 0;
+    int minLength = 4;
+    QVector<Section> sections; //!< sorted by paddr
+};
+
+/**
+ * @brief Scans a StringsSource for ASCII, UTF-8 and UTF-16LE strings, reporting them in batches
+ * while the scan is running.
+ */
 class StringsTask : public AsyncTask
 {
 Q_OBJECT
 
 public:
+    static const int batchSize = 4096;
+    static const ut64 chunkSize = 1 << 20;
+
+    explicit StringsTask(QSharedPointer<const StringsSource> source);
+
     QString getTitle() override                     { return tr("Searching for Strings"); }
 
 signals:
-    void stringSearchFinished(const QList<StringDescription> &strings);
+    void stringsFound(const QVector<ScannedString> &strings);
 
 protected:
-    void runTask() override
-    {
-        auto strings = Core()->getAllStrings();
-        emit stringSearchFinished(strings);
-    }
+    void runTask() override;
+
+private:
+    QSharedPointer<const StringsSource> source;
 };
 
 #endif //STRINGSASYNCTASK_H
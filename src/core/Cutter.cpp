@@ -4,6 +4,7 @@
 #include <QDir>
 #include <QCoreApplication>
 #include <QVector>
+#include <QHash>
 #include <QStringList>
 #include <QStandardPaths>
 
@@ -225,6 +226,11 @@ void CutterCore::initialize(bool loadPlugins)
 
     // Initialize Async tasks manager
     asyncTaskManager = new AsyncTaskManager(this);
+
+    updateRenderConfig();
+    connect(this, &CutterCore::asmOptionsChanged, this, &CutterCore::updateRenderConfig);
+    connect(this, &CutterCore::graphOptionsChanged, this, &CutterCore::updateRenderConfig);
+    connect(this, &CutterCore::refreshAll, this, &CutterCore::updateRenderConfig);
 }
 
 CutterCore::~CutterCore()
@@ -1024,6 +1030,20 @@ QString CutterCore::getConfigDescription(const char *k)
     return node ? QString(node->desc) : QString("Unrecognized configuration key");
 }
 
+std::shared_ptr<const RenderConfig> CutterCore::getRenderConfig() const
+{
+    return std::atomic_load(&renderConfig);
+}
+
+void CutterCore::updateRenderConfig()
+{
+    auto config = std::make_shared<RenderConfig>();
+    config->asmBytes = getConfigb("asm.bytes");
+    config->asmEmu = getConfigb("asm.emu");
+    config->graphBlockMaxChars = Config()->getGraphBlockMaxChars();
+    std::atomic_store(&renderConfig, std::shared_ptr<const RenderConfig>(std::move(config)));
+}
+
 void CutterCore::triggerRefreshAll()
 {
     emit refreshAll();
@@ -2565,19 +2585,36 @@ QList<ImportDescription> CutterCore::getAllImports()
     CORE_LOCK();
     QList<ImportDescription> ret;
 
-    QJsonArray importsArray = cmdj("iij").array();
+    if (!core || !core->bin || !core->bin->cur || !core->bin->cur->o) {
+        return ret;
+    }
+    RBinObject *o = core->bin->cur->o;
 
-    for (const QJsonValue &value : importsArray) {
-        QJsonObject importObject = value.toObject();
+    // plt entries are the "imp." symbols, same lookup as "iij" does for every import
+    QHash<QString, RVA> pltAddresses;
+    RListIter *it;
+    RBinSymbol *bs;
+    CutterRListForeach(o->symbols, it, RBinSymbol, bs) {
+        if (bs->name && !strncmp(bs->name, "imp.", 4)) {
+            pltAddresses.insert(QString::fromUtf8(bs->name + 4), bs->vaddr);
+        }
+    }
 
+    ret.reserve(r_list_length(o->imports));
+    RBinImport *bi;
+    CutterRListForeach(o->imports, it, RBinImport, bi) {
         ImportDescription import;
 
-        import.plt = importObject[RJsonKey::plt].toVariant().toULongLong();
-        import.ordinal = importObject[RJsonKey::ordinal].toInt();
-        import.bind = importObject[RJsonKey::bind].toString();
-        import.type = importObject[RJsonKey::type].toString();
-        import.libname = importObject[RJsonKey::libname].toString();
-        import.name = importObject[RJsonKey::name].toString();
+        QString name = QString::fromUtf8(bi->name);
+        import.plt = pltAddresses.value(name, 0);
+        if (bi->classname && bi->classname[0]) {
+            name = QString::fromUtf8(bi->classname) + "." + name;
+        }
+        import.ordinal = bi->ordinal;
+        import.bind = QString::fromUtf8(bi->bind);
+        import.type = QString::fromUtf8(bi->type);
+        import.libname = QString::fromUtf8(bi->libname);
+        import.name = name;
 
         ret << import;
     }
@@ -2590,19 +2627,37 @@ QList<ExportDescription> CutterCore::getAllExports()
     CORE_LOCK();
     QList<ExportDescription> ret;
 
-    QJsonArray exportsArray = cmdj("iEj").array();
+    if (!core || !core->bin || !core->bin->cur || !core->bin->cur->o) {
+        return ret;
+    }
 
-    for (const QJsonValue &value : exportsArray) {
-        QJsonObject exportObject = value.toObject();
+    RListIter *it;
+    RBinSymbol *bs;
+    CutterRListForeach(core->bin->cur->o->symbols, it, RBinSymbol, bs) {
+        // same filter as "iE"
+        if (!bs->name || !strncmp(bs->name, "imp.", 4)
+                || !bs->bind || strcmp(bs->bind, R_BIN_BIND_GLOBAL_STR)) {
+            continue;
+        }
 
         ExportDescription exp;
 
-        exp.vaddr = exportObject[RJsonKey::vaddr].toVariant().toULongLong();
-        exp.paddr = exportObject[RJsonKey::paddr].toVariant().toULongLong();
-        exp.size = exportObject[RJsonKey::size].toVariant().toULongLong();
-        exp.type = exportObject[RJsonKey::type].toString();
-        exp.name = exportObject[RJsonKey::name].toString();
-        exp.flag_name = exportObject[RJsonKey::flagname].toString();
+        exp.vaddr = bs->vaddr;
+        exp.paddr = bs->paddr;
+        exp.size = bs->size;
+        exp.type = QString::fromUtf8(bs->type);
+        exp.name = QString::fromUtf8(bs->name);
+
+        // flag name as created by r2 when loading the symbols
+        const char *prefix = "sym";
+        if (bs->type && !strcmp(bs->type, R_BIN_TYPE_NOTYPE_STR)) {
+            prefix = "loc";
+        } else if (bs->type && !strcmp(bs->type, R_BIN_TYPE_OBJECT_STR)) {
+            prefix = "obj";
+        }
+        QByteArray flagName = QByteArray(prefix) + "." + bs->name;
+        r_name_filter(flagName.data(), flagName.size());
+        exp.flag_name = QString::fromUtf8(flagName.constData());
 
         ret << exp;
     }
@@ -2782,13 +2837,12 @@ QList<FlagspaceDescription> CutterCore::getAllFlagspaces()
     CORE_LOCK();
     QList<FlagspaceDescription> ret;
 
-    QJsonArray flagspacesArray = cmdj("fsj").array();
-    for (const QJsonValue &value : flagspacesArray) {
-        QJsonObject flagspaceObject = value.toObject();
-
+    RSpaceIter it;
+    RSpace *space;
+    r_flag_space_foreach(core->flags, it, space) {
         FlagspaceDescription flagspace;
 
-        flagspace.name = flagspaceObject[RJsonKey::name].toString();
+        flagspace.name = QString::fromUtf8(space->name);
 
         ret << flagspace;
     }
@@ -2800,23 +2854,25 @@ QList<FlagDescription> CutterCore::getAllFlags(QString flagspace)
     CORE_LOCK();
     QList<FlagDescription> ret;
 
-    if (!flagspace.isEmpty())
-        cmdRaw("fs " + flagspace);
-    else
-        cmdRaw("fs *");
-
-    QJsonArray flagsArray = cmdj("fj").array();
-    for (const QJsonValue &value : flagsArray) {
-        QJsonObject flagObject = value.toObject();
-
+    auto addFlag = [](RFlagItem *item, void *user) -> bool {
         FlagDescription flag;
 
-        flag.offset = flagObject[RJsonKey::offset].toVariant().toULongLong();
-        flag.size = flagObject[RJsonKey::size].toVariant().toULongLong();
-        flag.name = flagObject[RJsonKey::name].toString();
-        flag.realname = flagObject[RJsonKey::realname].toString();
+        flag.offset = item->offset;
+        flag.size = item->size;
+        flag.name = QString::fromUtf8(item->name);
+        flag.realname = QString::fromUtf8(item->realname ? item->realname : item->name);
+
+        *static_cast<QList<FlagDescription> *>(user) << flag;
+        return true;
+    };
 
-        ret << flag;
+    if (flagspace.isEmpty()) {
+        r_flag_foreach(core->flags, addFlag, &ret);
+    } else {
+        RSpace *space = r_flag_space_get(core->flags, flagspace.toUtf8().constData());
+        if (space) {
+            r_flag_foreach_space(core->flags, space, addFlag, &ret);
+        }
     }
     return ret;
 }
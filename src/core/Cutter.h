@@ -16,6 +16,8 @@
 #include <QMutex>
 #include <QDir>
 
+#include <memory>
+
 class AsyncTaskManager;
 class BasicInstructionHighlighter;
 class CutterCore;
@@ -33,6 +35,21 @@ class R2TaskDialog;
 
 class RCoreLocked;
 
+/**
+ * @brief Immutable snapshot of the r2 and Cutter settings needed while rendering code.
+ * @see CutterCore::getRenderConfig()
+ */
+struct RenderConfig {
+    bool asmBytes = false;
+    bool asmEmu = false;
+    int graphBlockMaxChars = 100;
+
+    /**
+     * @brief Number of characters after which an instruction is cropped in a graph block.
+     */
+    int graphBlockLength() const { return graphBlockMaxChars + asmBytes * 24 + asmEmu * 10; }
+};
+
 class CUTTER_EXPORT CutterCore: public QObject
 {
     Q_OBJECT
@@ -310,6 +327,14 @@ public:
     QString getConfigDescription(const char *k);
     QList<QString> getColorThemes();
 
+    /**
+     * @brief Settings used by the render paths, without taking the core lock.
+     *
+     * The snapshot is rebuilt on asmOptionsChanged, graphOptionsChanged and refreshAll.
+     * It can be read from any thread, a snapshot that was already obtained is never modified.
+     */
+    std::shared_ptr<const RenderConfig> getRenderConfig() const;
+
     /* Assembly\Hexdump related methods */
     QByteArray assemble(const QString &code);
     QString disassemble(const QByteArray &data);
@@ -727,6 +752,9 @@ private:
 
     QSharedPointer<R2Task> debugTask;
     R2TaskDialog *debugTaskDialog;
+
+    std::shared_ptr<const RenderConfig> renderConfig;
+    void updateRenderConfig();
     
     QVector<QString> getCutterRCFilePaths() const;
 };
@@ -78,6 +78,7 @@
 #include "widgets/CallGraph.h"
 
 #include "plugins/ppCutter/core/PPCutterCore.h"
+#include "plugins/ppCutter/core/PPTask.h"
 
 // Qt Headers
 #include <QApplication>
@@ -217,6 +218,14 @@ void MainWindow::initUI()
 
     connect(core, &CutterCore::ioModeChanged, this, &MainWindow::setAvailableIOModeOptions);
 
+    // pp actions must not touch the file while a pp task owns it
+    connect(PPCore(), &PPCutterCore::busyChanged, this, [this](bool busy) {
+        for (QAction *action : { ui->actionPPProjectLoad, ui->actionPPProjectSave, ui->actionPPReload,
+                                 ui->actionPPDecompile, ui->actionPPCalculate }) {
+            action->setEnabled(!busy);
+        }
+    });
+
     QActionGroup *ioModeActionGroup = new QActionGroup(this);
 
     ioModeActionGroup->addAction(ui->actionCacheMode);
@@ -1492,7 +1501,9 @@ void MainWindow::on_actionPPProjectLoad_triggered()
     }
 
     if (fileNames.size() >= 1) {
-        PPCore()->loadProject(fileNames[0].toStdString());
+        auto *loadTask = new PPTask(PPTask::Operation::LoadProject);
+        loadTask->setFileName(fileNames[0]);
+        startPPTask(loadTask);
     }
 }
 
@@ -1508,24 +1519,60 @@ void MainWindow::on_actionPPProjectSave_triggered()
         fileNames = dialog.selectedFiles();
     }
 
-    if (fileNames.size() >= 1) {
+    if (fileNames.size() >= 1 && !PPCore()->isBusy()) {
         PPCore()->saveProject(fileNames[0].toStdString());
     }
 }
 
 void MainWindow::on_actionPPReload_triggered()
 {
-    PPCore()->loadFile(filename.toStdString());
+    auto *reloadTask = new PPTask(PPTask::Operation::Reload);
+    reloadTask->setFileName(filename);
+    startPPTask(reloadTask);
 }
 
 void MainWindow::on_actionPPDecompile_triggered()
 {
-    PPCore()->disassembleAll();
+    startPPTask(new PPTask(PPTask::Operation::Disassemble));
 }
 
 void MainWindow::on_actionPPCalculate_triggered()
 {
-    PPCore()->calculateAll();
+    startPPTask(new PPTask(PPTask::Operation::Calculate));
+}
+
+/**
+ * @brief Runs a pp operation on the task thread pool. The file is marked busy until
+ * the task has finished, then the pp views are refreshed through PPCutterCore's signals.
+ */
+void MainWindow::startPPTask(PPTask *task)
+{
+    AsyncTask::Ptr taskPtr(task);
+    if (ppTask || PPCore()->isBusy()) {
+        // another pp task is still working on the file
+        return;
+    }
+    ppTask = taskPtr;
+    PPCore()->setBusy(true);
+    connect(task, &AsyncTask::finished, this, [this, task]() {
+        bool changedState = task->hasChangedState();
+        bool changedAnnotations = task->hasChangedAnnotations();
+        ppTask.clear();
+        PPCore()->setBusy(false);
+        if (changedAnnotations) {
+            PPCore()->registerAnnotationChange();
+        }
+        if (changedState) {
+            PPCore()->registerStateChange();
+        }
+    });
+
+    auto *taskDialog = new AsyncTaskDialog(taskPtr, this);
+    taskDialog->setInterruptOnClose(true);
+    taskDialog->setAttribute(Qt::WA_DeleteOnClose);
+    taskDialog->show();
+
+    Core()->getAsyncTaskManager()->start(taskPtr);
 }
 
 void MainWindow::on_actionSave_triggered()
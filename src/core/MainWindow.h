@@ -8,6 +8,7 @@
 #include "common/InitialOptions.h"
 #include "common/IOModesController.h"
 #include "common/CutterLayout.h"
+#include "common/AsyncTask.h"
 #include "MemoryDockWidget.h"
 
 #include <memory>
@@ -17,6 +18,7 @@
 
 class AnnotationsWidget;
 class PPGraphView;
+class PPTask;
 class AnnotationsEditorDockWidget;
 class CutterCore;
 class Omnibar;
@@ -280,6 +282,7 @@ private:
     CutterDockWidget   *memoryMapDock = nullptr;
     QDockWidget        *ppGraphDock = nullptr;
     PPGraphView        *ppGraphView = nullptr;
+    AsyncTask::Ptr      ppTask;
     NewFileDialog      *newFileDialog = nullptr;
     CutterDockWidget   *breakpointDock = nullptr;
     CutterDockWidget   *registerRefsDock = nullptr;
@@ -328,6 +331,7 @@ private:
 
     void setOverviewData();
     bool isOverviewActive();
+    void startPPTask(PPTask *task);
     /**
      * @brief Check if a widget is one of debug specific dock widgets.
      * @param dock
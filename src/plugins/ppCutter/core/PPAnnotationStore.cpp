@@ -0,0 +1,160 @@
+#include "plugins/ppCutter/core/PPAnnotationStore.h"
+
+#include <algorithm>
+#include <numeric>
+
+PPAnnotationStore::Handle PPAnnotationStore::insert(std::shared_ptr<Annotation> annotation)
+{
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.push_back({ 0, 0 });
+    }
+    slots[slot].position = static_cast<uint32_t>(annotations.size());
+    slotOfAnnotation[annotation.get()] = slot;
+    slotOfPosition.push_back(slot);
+    if (indexValid) {
+        addToIndex(annotation);
+    }
+    annotations.push_back(std::move(annotation));
+    return { slot, slots[slot].generation };
+}
+
+bool PPAnnotationStore::erase(Handle handle)
+{
+    if (!handle.isValid() || handle.slot >= slots.size()
+        || slots[handle.slot].generation != handle.generation) {
+        return false;
+    }
+
+    uint32_t position = slots[handle.slot].position;
+    const Annotation *annotation = annotations[position].get();
+    if (indexValid) {
+        removeFromIndex(annotation);
+    }
+    slotOfAnnotation.erase(annotation);
+
+    // move the last annotation into the hole
+    uint32_t last = static_cast<uint32_t>(annotations.size() - 1);
+    if (position != last) {
+        annotations[position] = std::move(annotations[last]);
+        slotOfPosition[position] = slotOfPosition[last];
+        slots[slotOfPosition[position]].position = position;
+    }
+    annotations.pop_back();
+    slotOfPosition.pop_back();
+
+    slots[handle.slot].generation++;
+    freeSlots.push_back(handle.slot);
+    return true;
+}
+
+bool PPAnnotationStore::erase(const Annotation *annotation)
+{
+    return erase(handleOf(annotation));
+}
+
+void PPAnnotationStore::assign(std::vector<std::shared_ptr<Annotation>> newAnnotations)
+{
+    clear();
+    annotations = std::move(newAnnotations);
+    slots.reserve(annotations.size());
+    slotOfPosition.resize(annotations.size());
+    std::iota(slotOfPosition.begin(), slotOfPosition.end(), 0);
+    slotOfAnnotation.reserve(annotations.size());
+    for (uint32_t i = 0; i < annotations.size(); i++) {
+        slots.push_back({ i, 0 });
+        slotOfAnnotation[annotations[i].get()] = i;
+    }
+    indexValid = false;
+}
+
+void PPAnnotationStore::clear()
+{
+    annotations.clear();
+    slotOfPosition.clear();
+    slots.clear();
+    freeSlots.clear();
+    slotOfAnnotation.clear();
+    indexAddresses.clear();
+    indexAnnotations.clear();
+    indexValid = true;
+}
+
+PPAnnotationStore::Handle PPAnnotationStore::handleOf(const Annotation *annotation) const
+{
+    auto it = slotOfAnnotation.find(annotation);
+    if (it == slotOfAnnotation.end()) {
+        return Handle();
+    }
+    return { it->second, slots[it->second].generation };
+}
+
+std::shared_ptr<Annotation> PPAnnotationStore::get(Handle handle) const
+{
+    if (!handle.isValid() || handle.slot >= slots.size()
+        || slots[handle.slot].generation != handle.generation) {
+        return nullptr;
+    }
+    return annotations[slots[handle.slot].position];
+}
+
+PPAnnotationStore::Range PPAnnotationStore::at(AddressType addr) const
+{
+    if (!indexValid) {
+        rebuildIndex();
+    }
+    auto range = std::equal_range(indexAddresses.begin(), indexAddresses.end(), addr);
+    if (range.first == range.second) {
+        return Range();
+    }
+    const std::shared_ptr<Annotation> *base = indexAnnotations.data();
+    return Range(base + (range.first - indexAddresses.begin()),
+                 base + (range.second - indexAddresses.begin()));
+}
+
+void PPAnnotationStore::rebuildIndex() const
+{
+    std::vector<std::pair<AddressType, uint32_t>> entries;
+    entries.reserve(annotations.size());
+    for (uint32_t i = 0; i < annotations.size(); i++) {
+        entries.emplace_back(annotations[i]->address, i);
+    }
+    std::sort(entries.begin(), entries.end());
+
+    indexAddresses.clear();
+    indexAnnotations.clear();
+    indexAddresses.reserve(entries.size());
+    indexAnnotations.reserve(entries.size());
+    for (const auto &entry : entries) {
+        indexAddresses.push_back(entry.first);
+        indexAnnotations.push_back(annotations[entry.second]);
+    }
+    indexValid = true;
+}
+
+void PPAnnotationStore::addToIndex(const std::shared_ptr<Annotation> &annotation)
+{
+    auto it = std::upper_bound(indexAddresses.begin(), indexAddresses.end(), annotation->address);
+    auto offset = it - indexAddresses.begin();
+    indexAddresses.insert(it, annotation->address);
+    indexAnnotations.insert(indexAnnotations.begin() + offset, annotation);
+}
+
+void PPAnnotationStore::removeFromIndex(const Annotation *annotation)
+{
+    auto range = std::equal_range(indexAddresses.begin(), indexAddresses.end(), annotation->address);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto offset = it - indexAddresses.begin();
+        if (indexAnnotations[offset].get() == annotation) {
+            indexAddresses.erase(it);
+            indexAnnotations.erase(indexAnnotations.begin() + offset);
+            return;
+        }
+    }
+    // the address was changed without invalidateIndex()
+    indexValid = false;
+}
@@ -0,0 +1,102 @@
+#ifndef PPANNOTATIONSTORE_H
+#define PPANNOTATIONSTORE_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <pp/types.h>
+#include <pp/annotations/Annotation.h>
+
+/**
+ * @brief Owns the annotations of a PPBinaryFile.
+ *
+ * Annotations are kept in one contiguous vector that can be handed to the pp
+ * library as is. A slot table maps stable handles to positions in that vector,
+ * so removing an annotation swaps the last one into its place instead of
+ * shifting the whole vector.
+ *
+ * Lookups by address go through a flat index sorted by address and return a
+ * range into it, without copying or allocating.
+ */
+class PPAnnotationStore
+{
+public:
+    struct Handle {
+        uint32_t slot = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool isValid() const { return slot != UINT32_MAX; }
+    };
+
+    /**
+     * @brief Annotations at one address. Only valid until the store is modified.
+     */
+    class Range
+    {
+    public:
+        using const_iterator = const std::shared_ptr<Annotation> *;
+
+        Range() = default;
+        Range(const_iterator first, const_iterator last) : first(first), last(last) {}
+
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+
+    private:
+        const_iterator first = nullptr;
+        const_iterator last = nullptr;
+    };
+
+    Handle insert(std::shared_ptr<Annotation> annotation);
+    bool erase(Handle handle);
+    bool erase(const Annotation *annotation);
+    void assign(std::vector<std::shared_ptr<Annotation>> annotations);
+    void clear();
+
+    Handle handleOf(const Annotation *annotation) const;
+    std::shared_ptr<Annotation> get(Handle handle) const;
+
+    /**
+     * @brief All annotations in no particular order.
+     */
+    const std::vector<std::shared_ptr<Annotation>> &all() const { return annotations; }
+    size_t size() const { return annotations.size(); }
+
+    /**
+     * @brief Annotations anchored at addr. Like DisassemblerState::annotations_by_address, the
+     * load addresses of LOAD_REF annotations are not indexed.
+     */
+    Range at(AddressType addr) const;
+
+    /**
+     * @brief Must be called after an address of a stored annotation was changed.
+     */
+    void invalidateIndex() { indexValid = false; }
+
+private:
+    struct Slot {
+        uint32_t position;
+        uint32_t generation;
+    };
+
+    std::vector<std::shared_ptr<Annotation>> annotations;
+    std::vector<uint32_t> slotOfPosition;    // parallel to annotations
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<const Annotation *, uint32_t> slotOfAnnotation;
+
+    // sorted by address, rebuilt lazily after bulk changes
+    mutable bool indexValid = true;
+    mutable std::vector<AddressType> indexAddresses;
+    mutable std::vector<std::shared_ptr<Annotation>> indexAnnotations;
+
+    void rebuildIndex() const;
+    void addToIndex(const std::shared_ptr<Annotation> &annotation);
+    void removeFromIndex(const Annotation *annotation);
+};
+
+#endif // PPANNOTATIONSTORE_H
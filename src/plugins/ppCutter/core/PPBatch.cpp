@@ -0,0 +1,174 @@
+#include "plugins/ppCutter/core/PPBatch.h"
+#include "plugins/ppCutter/core/PPBinaryFile.h"
+#include "plugins/ppCutter/core/PPBinaryProject.h"
+
+#include <pp/annotations/AnnotationsHelper.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+PPBatch::PPBatch(const PPBatchOptions &options) :
+    options(options)
+{
+}
+
+int PPBatch::run()
+{
+    if (!options.convertOutput.isEmpty()) {
+        return convertProject() ? 0 : 1;
+    }
+
+    int jobs = options.jobs > 0 ? options.jobs : QThread::idealThreadCount();
+    jobs = std::max(1, std::min(jobs, options.inputFiles.size()));
+
+    if (!options.outputDir.isEmpty() && !QDir().mkpath(options.outputDir)) {
+        std::cerr << "PP: could not create " << options.outputDir.toStdString() << std::endl;
+        return options.inputFiles.size();
+    }
+    if (!checkOutputPaths()) {
+        return options.inputFiles.size();
+    }
+
+    std::atomic<int> next(0);
+    std::atomic<int> failed(0);
+    auto worker = [&]() {
+        int index;
+        while ((index = next++) < options.inputFiles.size()) {
+            if (!processFile(options.inputFiles[index])) {
+                failed++;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < jobs; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "PP: processed " << options.inputFiles.size() << " files, "
+              << failed << " failed" << std::endl;
+    return failed;
+}
+
+std::unique_ptr<PPBinaryFile> PPBatch::loadFile(const QString &inputFile)
+{
+    // LLVM target initialization and ELF loading are not meant to run concurrently
+    static std::mutex loadMutex;
+
+    std::unique_ptr<PPBinaryFile> file;
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        // PPBinaryFile exits the process on files it cannot load
+        ELFIO::elfio probe;
+        if (!QFileInfo(inputFile).isFile() || !probe.load(inputFile.toStdString())) {
+            std::cerr << "PP: '" << inputFile.toStdString() << "' is not an ELF file" << std::endl;
+            return nullptr;
+        }
+        file = std::make_unique<PPBinaryFile>(inputFile.toStdString());
+    }
+    if (!file->isSupported()) {
+        std::cerr << "PP: '" << inputFile.toStdString() << "' has an unsupported architecture"
+                  << std::endl;
+        return nullptr;
+    }
+    return file;
+}
+
+bool PPBatch::processFile(const QString &inputFile)
+{
+    std::unique_ptr<PPBinaryFile> file = loadFile(inputFile);
+    if (!file) {
+        return false;
+    }
+
+    if (!options.projectFile.isEmpty()) {
+        std::vector<std::shared_ptr<Annotation>> annotations;
+        if (!PPBinaryProject::loadAnyFormat(*file, options.projectFile.toStdString(),
+                                            annotations)) {
+            std::cerr << "PP: could not load project '" << options.projectFile.toStdString()
+                      << "'" << std::endl;
+            return false;
+        }
+        file->setAnnotations(annotations);
+    }
+
+    if (!file->disassemble() || !file->calculateStates()) {
+        std::cerr << "PP: processing '" << inputFile.toStdString() << "' failed" << std::endl;
+        return false;
+    }
+
+    QString outputFile = outputPathFor(inputFile);
+    if (!file->writePatchedElf(outputFile.toStdString())) {
+        return false;
+    }
+    std::cout << "PP: wrote " << outputFile.toStdString() << std::endl;
+    return true;
+}
+
+QString PPBatch::outputPathFor(const QString &inputFile) const
+{
+    if (options.outputDir.isEmpty()) {
+        return inputFile + ".pp";
+    }
+    return QDir(options.outputDir).filePath(QFileInfo(inputFile).fileName());
+}
+
+bool PPBatch::checkOutputPaths() const
+{
+    QString outputDir;
+    if (!options.outputDir.isEmpty()) {
+        outputDir = QFileInfo(options.outputDir).canonicalFilePath();
+    }
+
+    QSet<QString> outputFiles;
+    for (const QString &inputFile : options.inputFiles) {
+        QFileInfo input(inputFile);
+        if (!outputDir.isEmpty() && input.absoluteDir().canonicalPath() == outputDir) {
+            std::cerr << "PP: output directory '" << options.outputDir.toStdString()
+                      << "' contains the input file '" << inputFile.toStdString()
+                      << "', it would be overwritten" << std::endl;
+            return false;
+        }
+        QString outputFile = QFileInfo(outputPathFor(inputFile)).absoluteFilePath();
+        if (outputFiles.contains(outputFile)) {
+            std::cerr << "PP: more than one input file would be written to '"
+                      << outputFile.toStdString() << "'" << std::endl;
+            return false;
+        }
+        outputFiles.insert(outputFile);
+    }
+    return true;
+}
+
+bool PPBatch::convertProject()
+{
+    if (options.inputFiles.size() != 1 || options.projectFile.isEmpty()) {
+        std::cerr << "PP: converting a project needs exactly one input file and a project"
+                  << std::endl;
+        return false;
+    }
+    std::unique_ptr<PPBinaryFile> file = loadFile(options.inputFiles.first());
+    if (!file) {
+        return false;
+    }
+    if (!PPBinaryProject::convert(*file, options.projectFile.toStdString(),
+                                  options.convertOutput.toStdString())) {
+        std::cerr << "PP: could not convert '" << options.projectFile.toStdString() << "'"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef PPBATCH_H
+#define PPBATCH_H
+
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+class PPBinaryFile;
+
+struct PPBatchOptions {
+    QStringList inputFiles;
+    QString projectFile;
+    QString outputDir;  // empty to write "<input>.pp" next to each input file
+    int jobs = 0;       // 0 to use QThread::idealThreadCount()
+    QString convertOutput;  // if set, only convert projectFile to a binary project
+};
+
+/**
+ * @brief Headless post-processing of many ELF files: load, apply an annotation
+ * project, disassemble, calculate states and write the patched ELF.
+ *
+ * Every file gets its own PPBinaryFile, so neither PPCutterCore nor any widget
+ * is involved and the files are processed in parallel.
+ */
+class PPBatch
+{
+public:
+    explicit PPBatch(const PPBatchOptions &options);
+
+    /**
+     * @brief Process all input files.
+     * @return number of files that could not be processed
+     */
+    int run();
+
+private:
+    PPBatchOptions options;
+
+    std::unique_ptr<PPBinaryFile> loadFile(const QString &inputFile);
+    bool processFile(const QString &inputFile);
+    bool convertProject();
+    QString outputPathFor(const QString &inputFile) const;
+    // rejects output paths that overwrite an input or are shared by several inputs
+    bool checkOutputPaths() const;
+};
+
+#endif // PPBATCH_H
@@ -7,7 +7,11 @@
 //#include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
+#include <string>
+#include <unordered_set>
 
 #include <pp/ElfPatcher.h>
 #include <pp/StateUpdateFunctions/crc/CrcStateUpdateFunction.hpp>
@@ -34,14 +38,15 @@
 
 #include "PPCutterCore.h"
 
-PPBinaryFile::PPBinaryFile(std::string inputFile)
+PPBinaryFile::PPBinaryFile(std::string inputFile) :
+  inputFile(inputFile)
 {
   std::cout << "inputFile: " << inputFile << std::endl;
   uint64_t k0 = 0x12345678;
   uint64_t k1 = 0x8765432100000000;
   int rounds = 12;
 
-  auto elf = std::make_unique<ELFIO::elfio>();
+  elf = std::make_unique<ELFIO::elfio>();
   if (!elf->load(inputFile))
   {
     std::cout << "PP: File not found" << std::endl;
@@ -117,24 +122,33 @@ void PPBinaryFile::createIndex()
     std::cout << "PP: Architecture of the elf file is not supported" << std::endl;
     return;
   }
-  AnnotationsHelper::prepareAnnotations(*state, annotations);
+  AnnotationsHelper::prepareAnnotations(*state, annotations.all());
 }
 
-void PPBinaryFile::disassemble()
+bool PPBinaryFile::disassemble(const ProgressCallback& progress)
 {
   if (!objDis || !state || !stateCalc) {
     std::cout << "PP: Architecture of the elf file is not supported" << std::endl;
-    return;
+    return false;
   }
-  AnnotationsHelper::prepareAnnotations(*state, annotations);
+  AnnotationsHelper::prepareAnnotations(*state, annotations.all());
 
   int num_rounds = 0;
+  bool aborted = false;
   try {
-    while (objDis->disassemble(*state)) num_rounds++;
+    while (objDis->disassemble(*state)) {
+      num_rounds++;
+      if (progress && !progress("Disassembly round " + std::to_string(num_rounds) + ": "
+                                + std::to_string(state->functions.size()) + " functions")) {
+        aborted = true;
+        break;
+      }
+    }
     std::cout << "rounds: " << num_rounds << std::endl;
     std::cout << "functions: " << state->functions.size() << std::endl;
   } catch (const Exception &e) {
     std::cout << "PP: Aborted disassembling due to exception: " << e.what() << std::endl;
+    aborted = true;
   }
 
   try {
@@ -142,83 +156,211 @@ void PPBinaryFile::disassemble()
     state->cleanupState();
   } catch (const Exception &e) {
     std::cout << "PP: could not prepare state due to: " << e.what() << std::endl;
+    aborted = true;
   }
 
-  buildFunctionCache();
-  PPCore()->registerStateChange();
+  if (!buildFunctionCache(progress))
+    aborted = true;
+
+  statesValid = false;
+  disassemblyDirty = aborted;
+  rebuildStateTable();
+  return !aborted;
 }
 
-bool PPBinaryFile::calculateStates()
+bool PPBinaryFile::calculateStates(const ProgressCallback& progress)
 {
-  std::vector<StateFixup> fixups;
+  if (statesValid) {
+    std::cout << "PP: states are up to date, skipping calculation" << std::endl;
+    return true;
+  }
+
+  if (progress && !progress("Calculating states of " + std::to_string(state->functions.size()) + " functions"))
+    return false;
+
+  auto start = std::chrono::steady_clock::now();
   try {
     fixups = stateCalc->calculate();
   } catch (const Exception &e) {
     std::cout << "Aborted calculation due to: " << e.what() << std::endl;
     return false;
   }
-  PPCore()->registerStateChange();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  std::cout << "PP: state calculation took " << elapsed.count() << " ms" << std::endl;
+
+  statesValid = true;
+  rebuildStateTable();
+  return true;
+}
+
+bool PPBinaryFile::writePatchedElf(const std::string& outputFile)
+{
+  if (!statesValid) {
+    std::cout << "PP: states have to be calculated before patching" << std::endl;
+    return false;
+  }
+
+  try {
+    ElfPatcher patcher(*elf, *state);
+    patcher.applyFixups(fixups);
+    patcher.save(outputFile);
+  } catch (const Exception &e) {
+    std::cout << "PP: could not patch '" << outputFile << "' due to: " << e.what() << std::endl;
+    return false;
+  }
   return true;
 }
 
-void PPBinaryFile::buildFunctionCache()
+bool PPBinaryFile::buildFunctionCache(const ProgressCallback& progress)
 {
+  // the cached block lists point into the previous disassembly
+  basicBlockCache.clear();
   entrypoint_ranges.clear();
+  entrypoint_range_max_end.clear();
+
+  // report roughly every percent, the task log is not meant for one line per function
+  size_t functionCount = state->functions.size();
+  size_t reportInterval = std::max<size_t>(1, functionCount / 100);
+  size_t functionIndex = 0;
+  bool aborted = false;
+
   for (auto &&function : state->functions) {
+    if (progress && functionIndex % reportInterval == 0
+        && !progress("Indexing function " + std::to_string(functionIndex + 1) + "/"
+                     + std::to_string(functionCount) + ": " + function.getJoinedName())) {
+      aborted = true;
+      break;
+    }
+    functionIndex++;
+
     for (auto &&entrypoint : function.getEntryPoints()) {
       AddressType end = 0;
-      for (auto &&bb : PPCore()->getBasicBlocksOfFunction(function, entrypoint.address, true)) {
+      for (auto &&bb : getBasicBlocksOfFunction(function, entrypoint.address, true)) {
         if (end < bb->getEndAddress())
           end = bb->getEndAddress();
       }
-      entrypoint_ranges.push_back({entrypoint.address, end, entrypoint.name});
+      entrypoint_ranges.push_back({entrypoint.address, end, &function, &entrypoint,
+                                   entrypoint_ranges.size()});
     }
   }
-}
 
-PPBinaryFile::~PPBinaryFile()
-{
+  std::stable_sort(entrypoint_ranges.begin(), entrypoint_ranges.end(),
+      [](const EntryPointRange& a, const EntryPointRange& b) { return a.start < b.start; });
+
+  entrypoint_range_max_end.reserve(entrypoint_ranges.size());
+  AddressType maxEnd = 0;
+  for (const EntryPointRange& epr : entrypoint_ranges) {
+    maxEnd = std::max(maxEnd, epr.end);
+    entrypoint_range_max_end.push_back(maxEnd);
+  }
+  return !aborted;
 }
 
-::Function* PPBinaryFile::getFunctionAt(AddressType addr) const
+const std::vector<const ::BasicBlock*>& PPBinaryFile::getBasicBlocksOfFunction(
+    ::Function& function, AddressType entrypointAddress, bool stopAtEntrypoints)
 {
-  std::string name;
-  for (const EntryPointRange& epr : entrypoint_ranges) {
-    if (addr >= epr.start && addr <= epr.end) {
-      name = epr.functionName;
-      break;
+  BasicBlockCacheKey key(&function, entrypointAddress, stopAtEntrypoints);
+  auto cached = basicBlockCache.find(key);
+  if (cached != basicBlockCache.end())
+    return cached->second;
+
+  std::vector<const ::BasicBlock*>& res = basicBlockCache[key];
+
+  const BasicBlock* entry = nullptr;
+  for (auto& frag : function) {
+    if (frag->getStartAddress() == entrypointAddress) {
+      entry = llvm::dyn_cast_or_null<BasicBlock>(frag);
+      if (entry != nullptr)
+        break;
     }
   }
-  for (auto &&function : state->functions) {
-//    if (function.getJoinedName() == name)
-//      return &function;
-
-    for (::Function::EntryPoint& ep : function.getEntryPoints()) {
-      if (ep.name == name) {
-        return &function;
-      }
+  if (entry == nullptr)
+    return res;
+
+  // iterative DFS, deep CFGs would overflow the stack when recursing
+  std::unordered_set<const ::BasicBlock*> visited;
+  std::vector<const ::BasicBlock*> worklist;
+  worklist.push_back(entry);
+  visited.insert(entry);
+  while (!worklist.empty()) {
+    const BasicBlock* bb = worklist.back();
+    worklist.pop_back();
+    res.push_back(bb);
+    for (auto successor = bb->succ_begin(); successor < bb->succ_end(); successor++) {
+      if (stopAtEntrypoints && function.isEntryPoint((**successor).getStartAddress()))
+        continue;
+      if (visited.insert(*successor).second)
+        worklist.push_back(*successor);
     }
   }
-  return nullptr;
+
+  std::sort(res.begin(), res.end(), [](const ::BasicBlock* a, const ::BasicBlock* b) {
+    return a->getStartAddress() < b->getStartAddress();
+  });
+  return res;
 }
 
-::Function::EntryPoint& PPBinaryFile::getEntrypointAt(AddressType addr) const
+const PPBinaryFile::EntryPointRange* PPBinaryFile::findEntryPointRange(AddressType addr) const
 {
-  std::string name;
-  for (const EntryPointRange& epr : entrypoint_ranges) {
-    if (addr >= epr.start && addr <= epr.end) {
-      name = epr.functionName;
+  // last range starting at or before addr
+  auto it = std::upper_bound(entrypoint_ranges.begin(), entrypoint_ranges.end(), addr,
+      [](AddressType a, const EntryPointRange& epr) { return a < epr.start; });
+
+  return findEntryPointRangeBefore(it - entrypoint_ranges.begin(), addr);
+}
+
+const PPBinaryFile::EntryPointRange* PPBinaryFile::findEntryPointRangeBefore(size_t count, AddressType addr) const
+{
+  // ranges may nest or overlap, so walk back as long as an earlier range can still reach addr
+  const EntryPointRange* res = nullptr;
+  for (size_t i = count; i > 0; i--) {
+    if (entrypoint_range_max_end[i - 1] < addr)
       break;
-    }
+    const EntryPointRange& epr = entrypoint_ranges[i - 1];
+    if (addr <= epr.end && (!res || epr.order < res->order))
+      res = &epr;
   }
-  for (auto &&function : state->functions) {
-    for (::Function::EntryPoint& ep : function.getEntryPoints()) {
-      if (ep.name == name) {
-        return ep;
-      }
+  return res;
+}
+
+PPBinaryFile::~PPBinaryFile()
+{
+}
+
+::Function* PPBinaryFile::getFunctionAt(AddressType addr) const
+{
+  const EntryPointRange* epr = findEntryPointRange(addr);
+  return epr ? epr->function : nullptr;
+}
+
+std::vector<::Function*> PPBinaryFile::getFunctionsAt(const std::vector<AddressType>& addrs) const
+{
+  std::vector<::Function*> res;
+  res.reserve(addrs.size());
+
+  // ranges starting at or before the current address, only grows as addrs is sorted
+  size_t count = 0;
+  for (size_t i = 0; i < addrs.size(); i++) {
+    AddressType addr = addrs[i];
+    assert(i == 0 || addrs[i - 1] <= addr);
+    if (i > 0 && addrs[i - 1] == addr) {
+      res.push_back(res.back());
+      continue;
     }
+    while (count < entrypoint_ranges.size() && entrypoint_ranges[count].start <= addr)
+      count++;
+    const EntryPointRange* epr = findEntryPointRangeBefore(count, addr);
+    res.push_back(epr ? epr->function : nullptr);
   }
-  assert(false);
+  return res;
+}
+
+::Function::EntryPoint& PPBinaryFile::getEntrypointAt(AddressType addr) const
+{
+  const EntryPointRange* epr = findEntryPointRange(addr);
+  assert(epr != nullptr);
+  return *epr->entrypoint;
 }
 
 AddressType PPBinaryFile::getStartAddressOfFunction(const ::Function& function) const
@@ -247,9 +389,9 @@ AddressType PPBinaryFile::getEndAddressOfFunction(const ::Function& function) co
   return end;
 }
 
-std::set<std::shared_ptr<Annotation>> PPBinaryFile::getAnnotationsAt(AddressType addr)
+PPAnnotationStore::Range PPBinaryFile::getAnnotationsAt(AddressType addr) const
 {
-  return state->annotations_by_address[addr];
+  return annotations.at(addr);
 }
 
 std::shared_ptr<Annotation> PPBinaryFile::createAnnotation(Annotation::Type type, AddressType anchorAddress)
@@ -274,9 +416,15 @@ std::shared_ptr<Annotation> PPBinaryFile::createAnnotation(Annotation::Type type
       assert(false);
   }
 
-  annotations.push_back(ret);
+  annotations.insert(ret);
 
-  AnnotationsHelper::prepareAnnotations(*state, annotations);
+  // only index the new annotation, disassemble() prepares all of them before it runs anyway
+  if (isSupported())
+    state->annotations_by_address[anchorAddress].insert(ret);
+  if (affectsDisassembly(type)) {
+    disassemblyDirty = true;
+    statesValid = false;
+  }
 
   PPCore()->registerAnnotationChange();
 
@@ -285,14 +433,43 @@ std::shared_ptr<Annotation> PPBinaryFile::createAnnotation(Annotation::Type type
 
 void PPBinaryFile::deleteAnnotation(std::shared_ptr<Annotation> annotation)
 {
-  annotations.erase(std::remove(annotations.begin(), annotations.end(), annotation), annotations.end());
+  annotations.erase(annotation.get());
+  if (isSupported()) {
+    auto it = state->annotations_by_address.find(annotation->address);
+    if (it != state->annotations_by_address.end())
+      it->second.erase(annotation);
+  }
+  if (affectsDisassembly(annotation->getType())) {
+    disassemblyDirty = true;
+    statesValid = false;
+  }
   PPCore()->registerAnnotationChange();
 }
 
-std::set<AddressType> PPBinaryFile::getAssociatedAddresses(AddressType addr)
+void PPBinaryFile::annotationModified(const std::shared_ptr<Annotation>& annotation, AddressType oldAddress)
+{
+  annotations.invalidateIndex();
+  if (isSupported() && annotation->address != oldAddress) {
+    auto it = state->annotations_by_address.find(oldAddress);
+    if (it != state->annotations_by_address.end())
+      it->second.erase(annotation);
+    state->annotations_by_address[annotation->address].insert(annotation);
+  }
+  if (affectsDisassembly(annotation->getType())) {
+    disassemblyDirty = true;
+    statesValid = false;
+  }
+}
+
+bool PPBinaryFile::affectsDisassembly(Annotation::Type type)
+{
+  return type != Annotation::Type::COMMENT;
+}
+
+std::set<AddressType> PPBinaryFile::getAssociatedAddresses(AddressType addr) const
 {
   std::set<AddressType> res;
-  for (auto& annotation : state->annotations_by_address[addr]) {
+  for (auto& annotation : annotations.at(addr)) {
     if (const LoadRefAnnotation* a = llvm::dyn_cast<LoadRefAnnotation>(annotation.get())) {
       res.insert(a->address);
       res.insert(a->addrLoad);
@@ -302,17 +479,75 @@ std::set<AddressType> PPBinaryFile::getAssociatedAddresses(AddressType addr)
   return res;
 }
 
-std::string PPBinaryFile::getStates(AddressType addr)
+void PPBinaryFile::rebuildStateTable()
 {
-  std::stringstream res;
-  if (stateCalc->preStates()->count(addr))
-    res << stateCalc->preStates()->at(addr);
-  else
-    res << "           ";
-  res << " -> ";
-  if (stateCalc->postStates()->count(addr))
-    res << stateCalc->postStates()->at(addr);
-  else
-    res << "           ";
-  return res.str();
+  stateTable = StateTable();
+
+  const auto* preStates = stateCalc->preStates();
+  const auto* postStates = stateCalc->postStates();
+
+  std::vector<AddressType> addrs;
+  addrs.reserve(preStates->size() + postStates->size());
+  for (auto &&entry : *preStates)
+    addrs.push_back(entry.first);
+  for (auto &&entry : *postStates)
+    addrs.push_back(entry.first);
+  std::sort(addrs.begin(), addrs.end());
+  addrs.erase(std::unique(addrs.begin(), addrs.end()), addrs.end());
+  if (addrs.empty())
+    return;
+
+  const std::string noState(11, ' ');
+  stateTable.lines.reserve(addrs.size());
+  for (AddressType addr : addrs) {
+    std::stringstream res;
+    if (preStates->count(addr))
+      res << preStates->at(addr);
+    else
+      res << noState;
+    res << " -> ";
+    if (postStates->count(addr))
+      res << postStates->at(addr);
+    else
+      res << noState;
+    stateTable.lines.push_back(res.str());
+  }
+
+  // instructions are at least 2 byte aligned on both supported architectures
+  bool aligned = std::all_of(addrs.begin(), addrs.end(),
+      [](AddressType addr) { return (addr & 1) == 0; });
+  stateTable.base = addrs.front();
+  stateTable.shift = aligned ? 1 : 0;
+  uint64_t span = ((uint64_t)(addrs.back() - addrs.front()) >> stateTable.shift) + 1;
+
+  // only use the dense table if it is not mostly empty
+  if (span <= 16 * (uint64_t)addrs.size()) {
+    stateTable.slots.assign(span, 0);
+    for (size_t i = 0; i < addrs.size(); i++)
+      stateTable.slots[(addrs[i] - stateTable.base) >> stateTable.shift] = i + 1;
+  } else {
+    stateTable.sparse.reserve(addrs.size());
+    for (size_t i = 0; i < addrs.size(); i++)
+      stateTable.sparse[addrs[i]] = i + 1;
+  }
+}
+
+const std::string& PPBinaryFile::getStates(AddressType addr) const
+{
+  static const std::string noStates = std::string(11, ' ') + " -> " + std::string(11, ' ');
+
+  uint32_t slot = 0;
+  if (!stateTable.slots.empty()) {
+    if (addr >= stateTable.base) {
+      uint64_t offset = addr - stateTable.base;
+      uint64_t index = offset >> stateTable.shift;
+      if ((index << stateTable.shift) == offset && index < stateTable.slots.size())
+        slot = stateTable.slots[index];
+    }
+  } else {
+    auto it = stateTable.sparse.find(addr);
+    if (it != stateTable.sparse.end())
+      slot = it->second;
+  }
+  return slot ? stateTable.lines[slot - 1] : noStates;
 }
@@ -2,6 +2,10 @@
 #define PPBINARYFILE_H
 
 #include <QVariant>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 #include <pp/types.h>
 #include <pp/config.h>
 #include <pp/StateCalculators/AEE/ApeStateCalculator.h>
@@ -16,6 +20,8 @@
 #include <pp/architecture/riscv/replace_instructions.h>
 #include <pp/architecture/thumbv7m/info.h>
 
+#include "plugins/ppCutter/core/PPAnnotationStore.h"
+
 Q_DECLARE_METATYPE(UpdateType)
 
 class PPBinaryFile
@@ -24,50 +30,119 @@ class PPBinaryFile
     struct EntryPointRange {
       AddressType start;
       AddressType end;
-      std::string functionName;
+      ::Function *function;
+      ::Function::EntryPoint *entrypoint;
+      size_t order; // position in function and entry point order
+    };
+
+    // prefix maximum of EntryPointRange::end, parallel to entrypoint_ranges
+    std::vector<AddressType> entrypoint_range_max_end;
+
+    const EntryPointRange* findEntryPointRange(AddressType addr) const;
+    // Of several ranges containing addr, the one that comes first in function and entry point
+    // order is returned, like a linear scan over the functions would find it.
+    // findEntryPointRangeBefore() only considers the first count ranges.
+    const EntryPointRange* findEntryPointRangeBefore(size_t count, AddressType addr) const;
+
+    // set by calculateStates(), cleared whenever disassembly or annotations change
+    bool statesValid = false;
+    // set when an annotation that influences disassembly was added, changed or removed
+    bool disassemblyDirty = true;
+
+    static bool affectsDisassembly(Annotation::Type type);
+
+    // Formatted "pre -> post" state of every instruction with a state. Addresses
+    // map to an index into lines, either through a dense table over
+    // [base, base + slots.size() << shift] or, for sparse layouts, a hash map.
+    struct StateTable {
+      AddressType base = 0;
+      unsigned shift = 0;
+      std::vector<uint32_t> slots; // index + 1 into lines, 0 if there is no state
+      std::unordered_map<AddressType, uint32_t> sparse;
+      std::vector<std::string> lines;
     };
+    StateTable stateTable;
+
+    void rebuildStateTable();
+
+    using BasicBlockCacheKey = std::tuple<const ::Function*, AddressType, bool>;
+    std::map<BasicBlockCacheKey, std::vector<const ::BasicBlock*>> basicBlockCache;
   public:
+    // Receives a progress message, returns false if the operation should be aborted.
+    using ProgressCallback = std::function<bool(const std::string& message)>;
+
     ELFIO::Elf_Half machine;
 
+    std::string inputFile;
+    std::unique_ptr<ELFIO::elfio> elf;
     std::unique_ptr<DisassemblerState> state;
     std::unique_ptr<ObjectDisassembler> objDis;
     std::unique_ptr<StateCalculator> stateCalc;
 
-    std::vector<std::shared_ptr<Annotation>> annotations;
+    PPAnnotationStore annotations;
 
+    // result of the last successful calculateStates()
+    std::vector<StateFixup> fixups;
+
+    // sorted by start address, built once in buildFunctionCache()
     std::vector<EntryPointRange> entrypoint_ranges;
 
     PPBinaryFile(std::string inputFile);
     ~PPBinaryFile();
     void createIndex();
-    void disassemble();
-    bool calculateStates();
-    void buildFunctionCache();
+    bool disassemble(const ProgressCallback& progress = ProgressCallback());
+    bool calculateStates(const ProgressCallback& progress = ProgressCallback());
+    bool buildFunctionCache(const ProgressCallback& progress = ProgressCallback());
+    bool writePatchedElf(const std::string& outputFile);
+
+    inline bool isSupported() const {
+      return objDis && state && stateCalc;
+    }
+
+    /**
+     * Basic blocks reachable from an entry point, sorted by start address. The
+     * result is cached until the disassembly (and with it the function cache)
+     * is rebuilt.
+     */
+    const std::vector<const ::BasicBlock*>& getBasicBlocksOfFunction(
+        ::Function& function, AddressType entrypointAddress, bool stopAtEntrypoints);
 
     ::Function* getFunctionAt(AddressType addr) const;
+    // same as getFunctionAt() for every address, in one pass over the function
+    // cache; the addresses have to be sorted in ascending order
+    std::vector<::Function*> getFunctionsAt(const std::vector<AddressType>& addrs) const;
     ::Function::EntryPoint& getEntrypointAt(AddressType addr) const;
     AddressType getStartAddressOfFunction(const ::Function& function) const;
     AddressType getEndAddressOfFunction(const ::Function& function) const;
 
-    std::set<std::shared_ptr<Annotation>> getAnnotationsAt(AddressType addr);
+    // the range is invalidated by the next change to the annotations
+    PPAnnotationStore::Range getAnnotationsAt(AddressType addr) const;
 
     std::shared_ptr<Annotation> createAnnotation(Annotation::Type type, AddressType anchorAddress);
     void deleteAnnotation(std::shared_ptr<Annotation> annotation);
+    // oldAddress is the address the annotation had before it was modified
+    void annotationModified(const std::shared_ptr<Annotation>& annotation, AddressType oldAddress);
+
+    inline bool needsDisassembly() const {
+      return disassemblyDirty;
+    }
 
-    std::set<AddressType> getAssociatedAddresses(AddressType addr);
+    std::set<AddressType> getAssociatedAddresses(AddressType addr) const;
 
-    std::string getStates(AddressType addr);
+    const std::string& getStates(AddressType addr) const;
 
     inline const DisassemblerState &getState() const {
       return *state;
     }
 
-    inline const std::vector<std::shared_ptr<Annotation>>& getAnnotations() {
-      return annotations;
+    inline const std::vector<std::shared_ptr<Annotation>>& getAnnotations() const {
+      return annotations.all();
     }
 
     inline void setAnnotations(std::vector<std::shared_ptr<Annotation>> _annotations) {
-      annotations = _annotations;
+      annotations.assign(std::move(_annotations));
+      disassemblyDirty = true;
+      statesValid = false;
     }
 };
 
@@ -0,0 +1,401 @@
+#include "plugins/ppCutter/core/PPBinaryProject.h"
+#include "plugins/ppCutter/core/PPBinaryFile.h"
+
+#include <pp/annotations/AnnotationsHelper.h>
+#include <pp/annotations/CommentAnnotation.h>
+#include <pp/annotations/EntrypointAnnotation.h>
+#include <pp/annotations/InstructionTypeAnnotation.h>
+#include <pp/annotations/LoadRefAnnotation.h>
+
+#include <llvm/Support/Casting.h>
+
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// All fields are stored little-endian with natural alignment, records are 8 byte aligned
+// and have no padding.
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t binaryHash;
+    uint32_t commentCount;
+    uint32_t entrypointCount;
+    uint32_t instTypeCount;
+    uint32_t loadRefCount;
+    uint64_t stringsSize;
+};
+
+struct StringRecord {
+    uint64_t address;
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct InstTypeRecord {
+    uint64_t address;
+    uint32_t instructionType;
+    uint32_t reserved;
+};
+
+struct LoadRefRecord {
+    uint64_t address;
+    uint64_t addrLoad;
+    uint64_t dataLoad;
+    uint32_t updateType;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 40, "unexpected Header layout");
+static_assert(sizeof(StringRecord) == 16, "unexpected StringRecord layout");
+static_assert(sizeof(InstTypeRecord) == 16, "unexpected InstTypeRecord layout");
+static_assert(sizeof(LoadRefRecord) == 32, "unexpected LoadRefRecord layout");
+
+const char projectMagic[4] = { 'P', 'P', 'A', 'N' };
+
+const InstructionType instructionTypes[] = {
+    UNKNOWN, SEQUENTIAL, DIRECT_CALL, INDIRECT_CALL, RETURN, TRAP, DIRECT_BRANCH,
+    INDIRECT_BRANCH, COND_BRANCH
+};
+const UpdateType updateTypes[] = {
+    UpdateType::INVALID, UpdateType::CONSTANT_LOAD, UpdateType::SIGNATURE_LOAD,
+    UpdateType::CONST_INJECTION
+};
+
+template<typename Enum, size_t N>
+bool enumFromRecord(uint32_t value, const Enum (&valid)[N], Enum &out)
+{
+    for (Enum e : valid) {
+        if (static_cast<uint32_t>(e) == value) {
+            out = e;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Converting to and from little-endian is the same byte swap, so these are used for both.
+template<typename T>
+void swapLittleEndian(T &value)
+{
+    value = qToLittleEndian(value);
+}
+
+void swapLittleEndian(Header &header)
+{
+    swapLittleEndian(header.version);
+    swapLittleEndian(header.binaryHash);
+    swapLittleEndian(header.commentCount);
+    swapLittleEndian(header.entrypointCount);
+    swapLittleEndian(header.instTypeCount);
+    swapLittleEndian(header.loadRefCount);
+    swapLittleEndian(header.stringsSize);
+}
+
+void swapLittleEndian(StringRecord &record)
+{
+    swapLittleEndian(record.address);
+    swapLittleEndian(record.offset);
+    swapLittleEndian(record.length);
+}
+
+void swapLittleEndian(InstTypeRecord &record)
+{
+    swapLittleEndian(record.address);
+    swapLittleEndian(record.instructionType);
+    swapLittleEndian(record.reserved);
+}
+
+void swapLittleEndian(LoadRefRecord &record)
+{
+    swapLittleEndian(record.address);
+    swapLittleEndian(record.addrLoad);
+    swapLittleEndian(record.dataLoad);
+    swapLittleEndian(record.updateType);
+    swapLittleEndian(record.reserved);
+}
+
+template<typename T>
+void appendRecord(QByteArray &out, T record)
+{
+    swapLittleEndian(record);
+    out.append(reinterpret_cast<const char *>(&record), sizeof(T));
+}
+
+template<typename T>
+T readRecord(const uchar *data, size_t index)
+{
+    T record;
+    memcpy(&record, data + index * sizeof(T), sizeof(T));
+    swapLittleEndian(record);
+    return record;
+}
+
+}
+
+bool PPBinaryProject::isBinaryProject(const std::string &path)
+{
+    QFile f(QString::fromStdString(path));
+    if (!f.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    char magic[sizeof(projectMagic)];
+    return f.read(magic, sizeof(magic)) == sizeof(magic)
+           && memcmp(magic, projectMagic, sizeof(magic)) == 0;
+}
+
+bool PPBinaryProject::hashBinary(const std::string &path, uint64_t &hash)
+{
+    QFile f(QString::fromStdString(path));
+    if (!f.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray ehdr = f.read(64);
+    if (ehdr.size() < 52 || memcmp(ehdr.constData(), "\x7f" "ELF", 4) != 0) {
+        return false;
+    }
+    const uchar *e = reinterpret_cast<const uchar *>(ehdr.constData());
+    const bool is64 = e[4] == 2;
+    const bool bigEndian = e[5] == 2;
+    const int ehdrSize = is64 ? 64 : 52;
+    if (ehdr.size() < ehdrSize) {
+        return false;
+    }
+    auto field = [&](int offset, int size) {
+        uint64_t value = 0;
+        for (int i = 0; i < size; i++) {
+            value = (value << 8) | e[offset + (bigEndian ? i : size - 1 - i)];
+        }
+        return value;
+    };
+
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto add = [&h](const char *data, qint64 size) {
+        for (qint64 i = 0; i < size; i++) {
+            h = (h ^ static_cast<uchar>(data[i])) * 0x100000001b3ULL;
+        }
+    };
+    const quint64 fileSize = qToLittleEndian<quint64>(static_cast<quint64>(f.size()));
+    add(reinterpret_cast<const char *>(&fileSize), sizeof(fileSize));
+    add(ehdr.constData(), ehdrSize);
+
+    // program and section header tables
+    const int countsOffset = is64 ? 0x36 : 0x2a;
+    const uint64_t tables[2][2] = {
+        { is64 ? field(0x20, 8) : field(0x1c, 4), field(countsOffset, 2) * field(countsOffset + 2, 2) },
+        { is64 ? field(0x28, 8) : field(0x20, 4), field(countsOffset + 4, 2) * field(countsOffset + 6, 2) },
+    };
+    for (const auto &table : tables) {
+        const uint64_t offset = table[0];
+        const uint64_t size = table[1];
+        if (!size) {
+            continue;
+        }
+        if (offset > static_cast<uint64_t>(f.size()) || size > static_cast<uint64_t>(f.size()) - offset
+                || !f.seek(static_cast<qint64>(offset))) {
+            return false;
+        }
+        const QByteArray data = f.read(static_cast<qint64>(size));
+        if (static_cast<uint64_t>(data.size()) != size) {
+            return false;
+        }
+        add(data.constData(), data.size());
+    }
+    hash = h;
+    return true;
+}
+
+bool PPBinaryProject::save(const PPBinaryFile &file, const std::string &path,
+                           const std::vector<std::shared_ptr<Annotation>> &annotations)
+{
+    QByteArray comments, entrypoints, instTypes, loadRefs, strings;
+    Header header = {};
+    memcpy(header.magic, projectMagic, sizeof(projectMagic));
+    header.version = version;
+    if (!hashBinary(file.inputFile, header.binaryHash)) {
+        std::cout << "PP: could not hash " << file.inputFile << " to save " << path << std::endl;
+        return false;
+    }
+
+    auto appendString = [&strings](AddressType address, const std::string &str) {
+        StringRecord record = {};
+        record.address = address;
+        record.offset = static_cast<uint32_t>(strings.size());
+        record.length = static_cast<uint32_t>(str.size());
+        strings.append(str.data(), static_cast<int>(str.size()));
+        return record;
+    };
+
+    for (const std::shared_ptr<Annotation> &annotation : annotations) {
+        if (const auto *a = llvm::dyn_cast<CommentAnnotation>(annotation.get())) {
+            appendRecord(comments, appendString(a->address, a->comment));
+            header.commentCount++;
+        } else if (const auto *a = llvm::dyn_cast<EntrypointAnnotation>(annotation.get())) {
+            appendRecord(entrypoints, appendString(a->address, a->name));
+            header.entrypointCount++;
+        } else if (const auto *a = llvm::dyn_cast<InstructionTypeAnnotation>(annotation.get())) {
+            InstTypeRecord record = {};
+            record.address = a->address;
+            record.instructionType = static_cast<uint32_t>(a->instructionType);
+            appendRecord(instTypes, record);
+            header.instTypeCount++;
+        } else if (const auto *a = llvm::dyn_cast<LoadRefAnnotation>(annotation.get())) {
+            LoadRefRecord record = {};
+            record.address = a->address;
+            record.addrLoad = a->addrLoad;
+            record.dataLoad = a->dataLoad;
+            record.updateType = static_cast<uint32_t>(a->updateType);
+            appendRecord(loadRefs, record);
+            header.loadRefCount++;
+        }
+    }
+
+    QSaveFile f(QString::fromStdString(path));
+    if (!f.open(QIODevice::WriteOnly)) {
+        std::cout << "PP: could not write project " << path << std::endl;
+        return false;
+    }
+    header.stringsSize = static_cast<uint64_t>(strings.size());
+    QByteArray headerData;
+    appendRecord(headerData, header);
+    f.write(headerData);
+    f.write(comments);
+    f.write(entrypoints);
+    f.write(instTypes);
+    f.write(loadRefs);
+    f.write(strings);
+    return f.commit();
+}
+
+bool PPBinaryProject::load(const PPBinaryFile &file, const std::string &path,
+                           std::vector<std::shared_ptr<Annotation>> &annotations)
+{
+    QFile f(QString::fromStdString(path));
+    if (!f.open(QIODevice::ReadOnly) || f.size() < static_cast<qint64>(sizeof(Header))) {
+        std::cout << "PP: could not read project " << path << std::endl;
+        return false;
+    }
+    const uchar *data = f.map(0, f.size());
+    if (!data) {
+        std::cout << "PP: could not map project " << path << std::endl;
+        return false;
+    }
+
+    Header header = readRecord<Header>(data, 0);
+    if (memcmp(header.magic, projectMagic, sizeof(projectMagic)) != 0 || header.version != version) {
+        std::cout << "PP: " << path << " is not a version " << version << " project" << std::endl;
+        return false;
+    }
+
+    // Every section has to fit into what is left of the file. Comparing against the
+    // remaining size instead of adding to the offset cannot overflow.
+    const uint64_t fileSize = static_cast<uint64_t>(f.size());
+    uint64_t offset = sizeof(Header);
+    auto takeSection = [&](uint64_t count, uint64_t recordSize, uint64_t &sectionOffset) {
+        if (count > (fileSize - offset) / recordSize) {
+            return false;
+        }
+        sectionOffset = offset;
+        offset += count * recordSize;
+        return true;
+    };
+    uint64_t commentsOffset, entrypointsOffset, instTypesOffset, loadRefsOffset;
+    if (!takeSection(header.commentCount, sizeof(StringRecord), commentsOffset)
+            || !takeSection(header.entrypointCount, sizeof(StringRecord), entrypointsOffset)
+            || !takeSection(header.instTypeCount, sizeof(InstTypeRecord), instTypesOffset)
+            || !takeSection(header.loadRefCount, sizeof(LoadRefRecord), loadRefsOffset)
+            || header.stringsSize != fileSize - offset) {
+        std::cout << "PP: project " << path << " is truncated or corrupt" << std::endl;
+        return false;
+    }
+    const uint64_t stringsOffset = offset;
+
+    // Annotations are stored by address, applying them to another build would patch the
+    // wrong instructions. Text projects are matched against the disassembly instead.
+    uint64_t binaryHash;
+    if (!hashBinary(file.inputFile, binaryHash)) {
+        std::cout << "PP: could not hash " << file.inputFile << " to check " << path << std::endl;
+        return false;
+    }
+    if (header.binaryHash != binaryHash) {
+        std::cout << "PP: project " << path << " was saved for a different build of "
+                  << file.inputFile << ", convert it from a text project for this build" << std::endl;
+        return false;
+    }
+
+    const char *strings = reinterpret_cast<const char *>(data + stringsOffset);
+    auto readString = [&](const StringRecord &record, std::string &out) {
+        if (static_cast<uint64_t>(record.offset) + record.length > header.stringsSize) {
+            return false;
+        }
+        out.assign(strings + record.offset, record.length);
+        return true;
+    };
+
+    std::vector<std::shared_ptr<Annotation>> res;
+    res.reserve(header.commentCount + header.entrypointCount + header.instTypeCount
+                + header.loadRefCount);
+
+    for (uint32_t i = 0; i < header.commentCount; i++) {
+        StringRecord record = readRecord<StringRecord>(data + commentsOffset, i);
+        auto a = std::make_shared<CommentAnnotation>(record.address);
+        if (!readString(record, a->comment)) {
+            return false;
+        }
+        res.push_back(a);
+    }
+    for (uint32_t i = 0; i < header.entrypointCount; i++) {
+        StringRecord record = readRecord<StringRecord>(data + entrypointsOffset, i);
+        auto a = std::make_shared<EntrypointAnnotation>(record.address);
+        if (!readString(record, a->name)) {
+            return false;
+        }
+        res.push_back(a);
+    }
+    for (uint32_t i = 0; i < header.instTypeCount; i++) {
+        InstTypeRecord record = readRecord<InstTypeRecord>(data + instTypesOffset, i);
+        auto a = std::make_shared<InstructionTypeAnnotation>(record.address);
+        if (!enumFromRecord(record.instructionType, instructionTypes, a->instructionType)) {
+            std::cout << "PP: project " << path << " has an invalid instruction type" << std::endl;
+            return false;
+        }
+        res.push_back(a);
+    }
+    for (uint32_t i = 0; i < header.loadRefCount; i++) {
+        LoadRefRecord record = readRecord<LoadRefRecord>(data + loadRefsOffset, i);
+        auto a = std::make_shared<LoadRefAnnotation>(record.address);
+        a->addrLoad = record.addrLoad;
+        a->dataLoad = record.dataLoad;
+        if (!enumFromRecord(record.updateType, updateTypes, a->updateType)) {
+            std::cout << "PP: project " << path << " has an invalid update type" << std::endl;
+            return false;
+        }
+        res.push_back(a);
+    }
+
+    annotations = std::move(res);
+    return true;
+}
+
+bool PPBinaryProject::loadAnyFormat(const PPBinaryFile &file, const std::string &path,
+                                    std::vector<std::shared_ptr<Annotation>> &annotations)
+{
+    if (isBinaryProject(path)) {
+        return load(file, path, annotations);
+    }
+    annotations = AnnotationsHelper::loadAndMatchAnnotationsFromFile(*file.state, path);
+    return true;
+}
+
+bool PPBinaryProject::convert(const PPBinaryFile &file, const std::string &textPath,
+                              const std::string &binaryPath)
+{
+    return save(file, binaryPath,
+                AnnotationsHelper::loadAndMatchAnnotationsFromFile(*file.state, textPath));
+}
@@ -0,0 +1,59 @@
+#ifndef PPBINARYPROJECT_H
+#define PPBINARYPROJECT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pp/annotations/Annotation.h>
+
+class PPBinaryFile;
+
+/**
+ * @brief Compact binary annotation project format.
+ *
+ * A file consists of a fixed header followed by one packed array per annotation
+ * type and a pool holding the comment and entry point strings:
+ *
+ *     Header | CommentRecord[] | EntrypointRecord[] | InstTypeRecord[] | LoadRefRecord[] | strings
+ *
+ * The header stores a hash of the ELF headers of the file the project was saved
+ * for, projects are only loaded for that build. Loading maps the file into memory and
+ * creates the annotations straight from the arrays, without the text parser
+ * and without matching them against the disassembly.
+ */
+class PPBinaryProject
+{
+public:
+    static constexpr uint32_t version = 2;
+
+    static bool isBinaryProject(const std::string &path);
+
+    static bool save(const PPBinaryFile &file, const std::string &path,
+                     const std::vector<std::shared_ptr<Annotation>> &annotations);
+    static bool load(const PPBinaryFile &file, const std::string &path,
+                     std::vector<std::shared_ptr<Annotation>> &annotations);
+
+    /**
+     * @brief Load a project in either format, text projects are matched against the disassembly.
+     */
+    static bool loadAnyFormat(const PPBinaryFile &file, const std::string &path,
+                              std::vector<std::shared_ptr<Annotation>> &annotations);
+
+    /**
+     * @brief Convert a text project (AnnotationsSerializer format) into the binary format.
+     */
+    static bool convert(const PPBinaryFile &file, const std::string &textPath,
+                        const std::string &binaryPath);
+
+    /**
+     * @brief FNV-1a hash of the size, ELF header and program and section header tables of an
+     * ELF file, used to detect projects saved for a different build. Only the headers are read,
+     * so the cost doesn't grow with the file; a rebuild that changes code but keeps every
+     * section at the same size and place is not detected.
+     * @return false if the file could not be read or is not an ELF file
+     */
+    static bool hashBinary(const std::string &path, uint64_t &hash);
+};
+
+#endif // PPBINARYPROJECT_H
@@ -29,12 +29,14 @@
 #include <pp/annotations/LoadRefAnnotation.h>
 
 #include "plugins/ppCutter/core/PPCutterCore.h"
+#include "plugins/ppCutter/core/PPBinaryProject.h"
 #include "Cutter.h"
 
 Q_GLOBAL_STATIC(ppccClass, uniqueInstance)
 
 PPCutterCore::PPCutterCore(QObject *parent) :
-        QObject(parent)
+        QObject(parent),
+        ready(false)
 {
     addAnnotationType(Annotation::Type::COMMENT, "comment");
     addAnnotationType(Annotation::Type::ENTRYPOINT, "entrypoint");
@@ -51,45 +53,23 @@ PPCutterCore::~PPCutterCore()
 {
 }
 
-void PPCutterCore::loadFile(std::string path)
+void PPCutterCore::loadFile(std::string path, const PPBinaryFile::ProgressCallback &progress)
 {
+    // views must not touch the file while it is being replaced
+    ready = false;
     std::vector<std::shared_ptr<Annotation>> annotations;
     if (file != nullptr) {
         annotations = file->getAnnotations();
     }
     file = std::make_unique<PPBinaryFile>(path);
     file->setAnnotations(annotations);
-    file->disassemble();
+    file->disassemble(progress);
     ready = true;
 }
 
-std::set<const ::BasicBlock*> PPCutterCore::getBasicBlocksOfFunction(::Function& function, AddressType entrypointAddress, bool stopAtEntrypoints)
+const std::vector<const ::BasicBlock*> &PPCutterCore::getBasicBlocksOfFunction(::Function& function, AddressType entrypointAddress, bool stopAtEntrypoints)
 {
-    std::set<const ::BasicBlock*> res;
-    for (auto& frag : function) {
-        //const ::Fragment* frag = *it;
-        if (frag->getStartAddress() == entrypointAddress) {
-            const BasicBlock *bb = llvm::dyn_cast_or_null<BasicBlock>(frag);
-            if (bb == nullptr)
-                continue;
-            getSuccessorsRecursive(function, res, *bb, stopAtEntrypoints);
-            break;
-        }
-    }
-    return res;
-}
-
-void PPCutterCore::getSuccessorsRecursive(::Function& function, std::set<const ::BasicBlock*>& collection, const ::BasicBlock& bb, bool stopAtEntrypoints)
-{
-    // if it was not visited before, add all successors
-    if (collection.insert(&bb).second) {
-        for (auto successor = bb.succ_begin(); successor < bb.succ_end(); successor++)
-        {
-            if (stopAtEntrypoints && function.isEntryPoint((**successor).getStartAddress()))
-                continue;
-            getSuccessorsRecursive(function, collection, **successor, stopAtEntrypoints);
-        }
-    }
+    return file->getBasicBlocksOfFunction(function, entrypointAddress, stopAtEntrypoints);
 }
 
 void PPCutterCore::addAnnotationType(Annotation::Type type, std::string str)
@@ -237,28 +217,47 @@ InstructionType PPCutterCore::instTypeFromString(const std::string str)
     return InstructionType::UNKNOWN;
 }
 
-void PPCutterCore::disassembleAll()
+bool PPCutterCore::disassembleAll(const PPBinaryFile::ProgressCallback &progress)
 {
     Core()->cmd("e asm.bits=16");
-    file->disassemble();
+    if (!file->needsDisassembly()) {
+        std::cout << "PP: disassembly is up to date" << std::endl;
+        return false;
+    }
+    file->disassemble(progress);
+    return true;
 }
 
-void PPCutterCore::calculateAll()
+bool PPCutterCore::calculateAll(const PPBinaryFile::ProgressCallback &progress)
 {
-    file->calculateStates();
+    return file->calculateStates(progress);
 }
 
-void PPCutterCore::loadProject(std::string filepath)
+bool PPCutterCore::loadProject(std::string filepath, const PPBinaryFile::ProgressCallback &progress)
 {
     get_logger()->set_level(spdlog::level::debug);
-    file->setAnnotations(AnnotationsHelper::loadAndMatchAnnotationsFromFile(*file->state, filepath));
-    file->disassemble();
-    emit annotationsChanged();
+    std::vector<std::shared_ptr<Annotation>> annotations;
+    if (!PPBinaryProject::loadAnyFormat(*file, filepath, annotations))
+        return false;
+    file->setAnnotations(annotations);
+    file->disassemble(progress);
+    return true;
 }
 
 void PPCutterCore::saveProject(std::string filepath)
 {
-    AnnotationsSerializer::saveAnnotationsToFile(*file->state, filepath, file->getAnnotations());
+    if (QString::fromStdString(filepath).endsWith(".ppb", Qt::CaseInsensitive))
+        PPBinaryProject::save(*file, filepath, file->getAnnotations());
+    else
+        AnnotationsSerializer::saveAnnotationsToFile(*file->state, filepath, file->getAnnotations());
+}
+
+void PPCutterCore::setBusy(bool busy)
+{
+    if (this->busy == busy)
+        return;
+    this->busy = busy;
+    emit busyChanged(busy);
 }
 
 void PPCutterCore::registerAnnotationChange()
@@ -8,7 +8,9 @@
 #include <QMessageBox>
 #include <QJsonDocument>
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 
 #include "PPBinaryFile.h"
@@ -26,7 +28,9 @@ private:
 
     std::unique_ptr<PPBinaryFile> file;
 
-    bool ready;
+    std::atomic<bool> ready;
+    // set on the GUI thread while a PPTask owns the file
+    bool busy = false;
     std::map<Annotation::Type, std::string> annotationTypeToStringMap;
     std::map<std::string, Annotation::Type> stringToAnnotationTypeMap;
     void addAnnotationType(Annotation::Type, std::string);
@@ -39,12 +43,20 @@ public:
     ~PPCutterCore();
     static PPCutterCore *getInstance();
 
-    void loadFile(std::string path);
+    /*
+     * The following operations modify the file and may run on a task thread,
+     * so they do not emit any signals. The caller announces the changes once
+     * it is back on the GUI thread.
+     */
+    void loadFile(std::string path,
+                  const PPBinaryFile::ProgressCallback &progress = PPBinaryFile::ProgressCallback());
+    // return true if the file has changed
+    bool disassembleAll(const PPBinaryFile::ProgressCallback &progress = PPBinaryFile::ProgressCallback());
+    bool calculateAll(const PPBinaryFile::ProgressCallback &progress = PPBinaryFile::ProgressCallback());
+    bool loadProject(std::string filepath,
+                     const PPBinaryFile::ProgressCallback &progress = PPBinaryFile::ProgressCallback());
 
-    void disassembleAll();
-    void calculateAll();
     void saveProject(std::string filepath);
-    void loadProject(std::string filepath);
 
     static QString toString(const UpdateType updateType);
     static QString toString(const InstructionType instructionType);
@@ -63,26 +75,36 @@ public:
     static InstructionType instTypeFromString(const std::string str);
 
 
-    std::set<const ::BasicBlock*> getBasicBlocksOfFunction(
+    /**
+     * @brief Basic blocks reachable from an entry point, sorted by start address.
+     * See PPBinaryFile::getBasicBlocksOfFunction().
+     */
+    const std::vector<const ::BasicBlock*> &getBasicBlocksOfFunction(
             ::Function& function,
             AddressType entrypointAddress,
             bool stopAtEntrypoints);
 
-    void getSuccessorsRecursive(
-            ::Function& function,
-            std::set<const ::BasicBlock*>& collection,
-            const ::BasicBlock& bb,
-            bool stopAtEntrypoints);
-
     std::map<Annotation::Type, std::string>& getAnnotationTypes() {
         return annotationTypeToStringMap;
     };
 
 
-    inline bool isReady() {
-        return ready;
+    /**
+     * @brief Whether the GUI may access the file. Only meaningful on the GUI thread.
+     */
+    inline bool isReady() const {
+        return ready && !busy;
     }
 
+    inline bool isBusy() const {
+        return busy;
+    }
+
+    /**
+     * @brief Called on the GUI thread when a PPTask starts or stops working on the file.
+     */
+    void setBusy(bool busy);
+
     inline const DisassemblerState &getState() const {
         return *file->state;
     }
@@ -101,6 +123,7 @@ public:
 signals:
     void annotationsChanged();
     void stateChanged();
+    void busyChanged(bool busy);
 
 public slots:
 
@@ -0,0 +1,72 @@
+#include "plugins/ppCutter/core/PPTask.h"
+#include "plugins/ppCutter/core/PPCutterCore.h"
+
+PPTask::PPTask(Operation operation) :
+    AsyncTask(),
+    operation(operation)
+{
+}
+
+PPTask::~PPTask()
+{
+}
+
+QString PPTask::getTitle()
+{
+    switch (operation) {
+    case Operation::Reload:
+        return tr("Reloading with pp");
+    case Operation::LoadProject:
+        return tr("Loading pp Project");
+    case Operation::Disassemble:
+        return tr("pp Disassembly");
+    case Operation::Calculate:
+        return tr("pp State Calculation");
+    }
+    return QString();
+}
+
+bool PPTask::reportProgress(const std::string &message)
+{
+    if (isInterrupted()) {
+        return false;
+    }
+    log(QString::fromStdString(message));
+    return true;
+}
+
+void PPTask::runTask()
+{
+    auto progress = [this](const std::string &message) {
+        return reportProgress(message);
+    };
+
+    switch (operation) {
+    case Operation::Reload:
+        log(tr("Loading %1...").arg(fileName));
+        PPCore()->loadFile(fileName.toStdString(), progress);
+        changedState = true;
+        break;
+    case Operation::LoadProject:
+        log(tr("Loading project %1...").arg(fileName));
+        changedState = changedAnnotations = PPCore()->loadProject(fileName.toStdString(), progress);
+        if (!changedState) {
+            log(tr("Could not load the project."));
+        }
+        break;
+    case Operation::Disassemble:
+        log(tr("Disassembling..."));
+        changedState = PPCore()->disassembleAll(progress);
+        break;
+    case Operation::Calculate:
+        log(tr("Calculating states..."));
+        changedState = PPCore()->calculateAll(progress);
+        break;
+    }
+
+    if (isInterrupted()) {
+        log(tr("Interrupted."));
+        return;
+    }
+    log(tr("Done."));
+}
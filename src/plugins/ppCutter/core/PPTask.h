@@ -0,0 +1,44 @@
+#ifndef PPTASK_H
+#define PPTASK_H
+
+#include "common/AsyncTask.h"
+
+#include <string>
+
+/**
+ * @brief Runs the long pp operations (reload, project loading, disassembly, state
+ * calculation) on the AsyncTaskManager thread pool instead of the GUI thread.
+ *
+ * The task has exclusive access to the PPBinaryFile, see PPCutterCore::setBusy().
+ * Changes are announced by whoever started the task once it has finished.
+ */
+class PPTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    enum class Operation { Reload, LoadProject, Disassemble, Calculate };
+
+    explicit PPTask(Operation operation);
+    ~PPTask();
+
+    QString getTitle() override;
+
+    void setFileName(const QString &fileName)    { this->fileName = fileName; }
+
+    bool hasChangedState() const                { return changedState; }
+    bool hasChangedAnnotations() const          { return changedAnnotations; }
+
+protected:
+    void runTask() override;
+
+private:
+    Operation operation;
+    QString fileName;
+    bool changedState = false;
+    bool changedAnnotations = false;
+
+    bool reportProgress(const std::string &message);
+};
+
+#endif // PPTASK_H
@@ -211,7 +211,7 @@ PPTreeItem* PPAnnotationDataModel::treeFromAnnotation(PPTreeItem *parent, std::s
     return annotationItem;
 }
 
-void PPAnnotationDataModel::setAnnotations(std::set<std::shared_ptr<Annotation>> annotations)
+void PPAnnotationDataModel::setAnnotations(PPAnnotationStore::Range annotations)
 {
     beginResetModel();
     rootItem->clearChildren();
@@ -228,9 +228,13 @@ void PPAnnotationDataModel::addAnnotation(std::shared_ptr<Annotation> annotation
 
 void PPAnnotationDataModel::save()
 {
+    if (!PPCore()->isReady())
+        return;
+
     for (int childIdx = 0; childIdx < rootItem->childCount(); childIdx++) {
         PPTreeItem* annotationItem = rootItem->child(childIdx);
         std::shared_ptr<Annotation> annotation = annotationItem->getAnnotationPtr();
+        AddressType oldAddress = annotation->address;
         for (int dataIdx = 0; dataIdx < annotationItem->childCount(); dataIdx++) {
             PPTreeItem* valueItem = annotationItem->child(dataIdx);
             QString key = valueItem->data(0).toString();
@@ -283,6 +287,7 @@ void PPAnnotationDataModel::save()
                     assert(false);
             }
         }
+        PPCore()->getFile().annotationModified(annotation, oldAddress);
     }
 
     PPCore()->registerAnnotationChange();
@@ -298,12 +303,14 @@ bool PPAnnotationDataModel::removeRows(int position, int rows, const QModelIndex
     if (position < 0 || position + rows > parentItem->childCount())
         return false;
 
+    if (!PPCore()->isReady())
+        return false;
+
     bool success = true;
 
     beginRemoveRows(parent, position, position + rows - 1);
     for (int pos = position; pos < position + rows; pos++)
         PPCore()->getFile().deleteAnnotation(parentItem->child(pos)->getAnnotationPtr());
-    PPCore()->getFile().createIndex();
     success = parentItem->removeChildren(position, rows);
     endRemoveRows();
 
@@ -6,6 +6,7 @@
 #include <QVariant>
 
 #include "PPTreeItem.h"
+#include "plugins/ppCutter/core/PPAnnotationStore.h"
 
 class PPAnnotationDataModel : public QAbstractItemModel
 {
@@ -33,7 +34,7 @@ public:
     bool removeRows(int position, int rows,
                     const QModelIndex &parent = QModelIndex()) override;
 
-    void setAnnotations(std::set<std::shared_ptr<Annotation>> annotations);
+    void setAnnotations(PPAnnotationStore::Range annotations);
 
     void addAnnotation(std::shared_ptr<Annotation> annotation);
 
@@ -36,6 +36,15 @@ AnnotationsEditorWidget::AnnotationsEditorWidget(QWidget *parent, AddressType ad
 
     connect(ui->deleteButton, SIGNAL(clicked()), this, SLOT(deleteAnnotationTriggered()));
 
+    // no edits while a pp task owns the file, reload what it left behind afterwards
+    connect(PPCore(), &PPCutterCore::busyChanged, this, [this](bool busy) {
+        setEnabled(!busy);
+        if (!busy) {
+            setAddress(this->addr);
+        }
+    });
+    setEnabled(!PPCore()->isBusy());
+
     setAddress(addr);
 }
 
@@ -63,6 +72,9 @@ void AnnotationsEditorWidget::expandAll()
 
 void AnnotationsEditorWidget::addAnnotationTriggered(Annotation::Type type)
 {
+    if (!PPCore()->isReady())
+        return;
+
     std::shared_ptr<Annotation> annotation = PPCore()->getFile().createAnnotation(type, addr);
     dataModel->addAnnotation(annotation);
     ui->annotationsTreeView->reset();
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <iterator>
+
 #include <QMenu>
 #include <QResizeEvent>
 #include <QShortcut>
@@ -8,15 +11,21 @@
 #include "common/Helpers.h"
 #include "plugins/ppCutter/core/PPCutterCore.h"
 
-AnnotationsModel::AnnotationsModel(QList<std::shared_ptr<Annotation>> *Annotations,
-                             QMap<QString, QList<std::shared_ptr<Annotation>>> *nestedAnnotations,
-                             QObject *parent)
+const size_t AnnotationsModel::fetchBatchSize;
+
+AnnotationsModel::AnnotationsModel(QObject *parent)
     : QAbstractItemModel(parent),
-      annotations(Annotations),
-      nestedAnnotations(nestedAnnotations),
+      fetchedGroups(0),
       nested(false)
 {}
 
+bool AnnotationsModel::entryLess(const Entry &a, const Entry &b)
+{
+    if (a.address != b.address)
+        return a.address < b.address;
+    return a.annotation.get() < b.annotation.get();
+}
+
 bool AnnotationsModel::isNested() const
 {
     return nested;
@@ -26,6 +35,7 @@ void AnnotationsModel::setNested(bool nested)
 {
     beginResetModel();
     this->nested = nested;
+    fetchedGroups = std::min(groups.size(), fetchBatchSize);
     endResetModel();
 }
 
@@ -49,12 +59,10 @@ QModelIndex AnnotationsModel::parent(const QModelIndex &index) const
 int AnnotationsModel::rowCount(const QModelIndex &parent) const
 {
     if (!parent.isValid())
-        return (isNested() ? nestedAnnotations->size() : annotations->count());
+        return static_cast<int>(isNested() ? fetchedGroups : annotations.size());
 
-    if (isNested() && parent.internalId() == 0) {
-        QString fcnName = nestedAnnotations->keys().at(parent.row());
-        return nestedAnnotations->operator[](fcnName).size();
-    }
+    if (isNested() && parent.internalId() == 0)
+        return static_cast<int>(groups[parent.row()].entries.size());
 
     return 0;
 }
@@ -84,15 +92,17 @@ QVariant AnnotationsModel::data(const QModelIndex &index, int role) const
     }
 
     QString offset;
-    std::shared_ptr<Annotation> annotation;
+    const Entry *entry = nullptr;
     if (isNested()) {
-        offset = nestedAnnotations->keys().at(commentIndex);
+        const Group &group = groups[commentIndex];
+        offset = group.function;
         if (isSubnode) {
-            annotation = nestedAnnotations->operator[](offset).at(index.row());
+            entry = &group.entries[index.row()];
         }
     } else {
-        annotation = annotations->at(commentIndex);
+        entry = &annotations.at(commentIndex);
     }
+    Annotation *annotation = entry ? entry->annotation.get() : nullptr;
 
     switch (role)
     {
@@ -105,7 +115,7 @@ QVariant AnnotationsModel::data(const QModelIndex &index, int role) const
                 case TypeNestedColumn:
                     return QString::fromStdString(PPCore()->toString(annotation->getType()));
                 case DataNestedColumn:
-                    return PPCore()->annotationDataToString(annotation.get());
+                    return PPCore()->annotationDataToString(annotation);
                 default:
                     break;
                 }
@@ -117,11 +127,11 @@ QVariant AnnotationsModel::data(const QModelIndex &index, int role) const
             case AnnotationsModel::OffsetColumn:
                 return RAddressString(annotation->address);
             case AnnotationsModel::FunctionColumn:
-                return QString::fromStdString(PPCore()->getFile().getFunctionAt(annotation->address)->getJoinedName());
+                return entry->function;
             case TypeColumn:
                 return QString::fromStdString(PPCore()->toString(annotation->getType()));
             case DataColumn:
-                return PPCore()->annotationDataToString(annotation.get());
+                return PPCore()->annotationDataToString(annotation);
             default:
                 break;
             }
@@ -136,7 +146,7 @@ QVariant AnnotationsModel::data(const QModelIndex &index, int role) const
         if (isNested() && index.internalId() == 0) {
             break;
         }
-        return RAddressString(annotation->address) + " " + PPCore()->annotationDataToString(annotation.get());
+        return RAddressString(annotation->address) + " " + PPCore()->annotationDataToString(annotation);
     default:
         break;
     }
@@ -177,14 +187,161 @@ QVariant AnnotationsModel::headerData(int section, Qt::Orientation, int role) co
     return QVariant();
 }
 
-void AnnotationsModel::beginReloadAnnotations()
+bool AnnotationsModel::canFetchMore(const QModelIndex &parent) const
 {
-    beginResetModel();
+    return isNested() && !parent.isValid() && fetchedGroups < groups.size();
 }
 
-void AnnotationsModel::endReloadAnnotations()
+void AnnotationsModel::fetchMore(const QModelIndex &parent)
 {
-    endResetModel();
+    if (!canFetchMore(parent))
+        return;
+
+    size_t count = std::min(groups.size() - fetchedGroups, fetchBatchSize);
+    beginInsertRows(QModelIndex(), static_cast<int>(fetchedGroups),
+                    static_cast<int>(fetchedGroups + count - 1));
+    fetchedGroups += count;
+    endInsertRows();
+}
+
+void AnnotationsModel::setAnnotations(std::vector<Entry> entries)
+{
+    // entries are sorted by address, a stable sort by function keeps them that way within a group
+    std::vector<size_t> order(entries.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&entries](size_t a, size_t b) {
+        return entries[a].function < entries[b].function;
+    });
+
+    std::vector<Group> newGroups;
+    for (size_t i : order) {
+        if (newGroups.empty() || newGroups.back().function != entries[i].function)
+            newGroups.push_back({ entries[i].function, {} });
+        newGroups.back().entries.push_back(entries[i]);
+    }
+
+    updateEntries(QModelIndex(), annotations, std::move(entries), !isNested());
+    updateGroups(std::move(newGroups));
+
+    if (isNested() && fetchedGroups < fetchBatchSize)
+        fetchMore(QModelIndex());
+
+    // Annotations that stayed may still have been edited
+    if (isNested()) {
+        for (size_t row = 0; row < fetchedGroups; row++) {
+            QModelIndex parent = index(static_cast<int>(row), 0);
+            emit dataChanged(index(0, 0, parent),
+                             index(static_cast<int>(groups[row].entries.size()) - 1, NestedColumnCount - 1, parent));
+        }
+    } else if (!annotations.empty()) {
+        emit dataChanged(index(0, 0), index(static_cast<int>(annotations.size()) - 1, ColumnCount - 1));
+    }
+}
+
+void AnnotationsModel::updateEntries(const QModelIndex &parent, std::vector<Entry> &current,
+                                     std::vector<Entry> entries, bool notify)
+{
+    // Merge both sorted lists to find what changed, an annotation that moved to
+    // another function is removed and inserted again.
+    std::vector<size_t> removed;
+    std::vector<size_t> inserted;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < current.size() || j < entries.size()) {
+        if (j == entries.size() || (i < current.size() && entryLess(current[i], entries[j]))) {
+            removed.push_back(i++);
+        } else if (i == current.size() || entryLess(entries[j], current[i])) {
+            inserted.push_back(j++);
+        } else {
+            if (current[i].function != entries[j].function) {
+                removed.push_back(i);
+                inserted.push_back(j);
+            }
+            i++;
+            j++;
+        }
+    }
+
+    // Remove back to front, so the rows in front of a removed range keep their numbers
+    for (size_t k = removed.size(); k > 0;) {
+        size_t last = removed[--k];
+        size_t first = last;
+        while (k > 0 && removed[k - 1] == first - 1)
+            first = removed[--k];
+
+        if (notify)
+            beginRemoveRows(parent, static_cast<int>(first), static_cast<int>(last));
+        current.erase(current.begin() + first, current.begin() + last + 1);
+        if (notify)
+            endRemoveRows();
+    }
+
+    // What is left is entries without the inserted ones, so inserting front to back puts
+    // every range at its final row
+    for (size_t k = 0; k < inserted.size();) {
+        size_t first = inserted[k++];
+        size_t last = first;
+        while (k < inserted.size() && inserted[k] == last + 1)
+            last = inserted[k++];
+
+        if (notify)
+            beginInsertRows(parent, static_cast<int>(first), static_cast<int>(last));
+        current.insert(current.begin() + first,
+                       std::make_move_iterator(entries.begin() + first),
+                       std::make_move_iterator(entries.begin() + last + 1));
+        if (notify)
+            endInsertRows();
+    }
+}
+
+void AnnotationsModel::updateGroups(std::vector<Group> newGroups)
+{
+    // Same merge as in updateEntries(), one level up. Only groups that were already fetched
+    // are announced to the view, the others show up with the next fetchMore().
+    size_t i = 0;
+    size_t j = 0;
+    while (i < groups.size() || j < newGroups.size()) {
+        if (j == newGroups.size() || (i < groups.size() && groups[i].function < newGroups[j].function)) {
+            size_t end = i + 1;
+            while (end < groups.size() && (j == newGroups.size() || groups[end].function < newGroups[j].function))
+                end++;
+
+            size_t fetchedEnd = std::min(end, std::max(fetchedGroups, i));
+            bool notify = isNested() && i < fetchedEnd;
+            if (notify)
+                beginRemoveRows(QModelIndex(), static_cast<int>(i), static_cast<int>(fetchedEnd - 1));
+            groups.erase(groups.begin() + i, groups.begin() + end);
+            if (i < fetchedGroups)
+                fetchedGroups -= fetchedEnd - i;
+            if (notify)
+                endRemoveRows();
+        } else if (i == groups.size() || newGroups[j].function < groups[i].function) {
+            size_t end = j + 1;
+            while (end < newGroups.size() && (i == groups.size() || newGroups[end].function < groups[i].function))
+                end++;
+            size_t count = end - j;
+
+            bool notify = isNested() && i < fetchedGroups;
+            if (notify)
+                beginInsertRows(QModelIndex(), static_cast<int>(i), static_cast<int>(i + count - 1));
+            groups.insert(groups.begin() + i,
+                          std::make_move_iterator(newGroups.begin() + j),
+                          std::make_move_iterator(newGroups.begin() + end));
+            if (i < fetchedGroups)
+                fetchedGroups += count;
+            if (notify)
+                endInsertRows();
+            i += count;
+            j = end;
+        } else {
+            bool notify = isNested() && i < fetchedGroups;
+            updateEntries(notify ? index(static_cast<int>(i), 0) : QModelIndex(),
+                          groups[i].entries, std::move(newGroups[j].entries), notify);
+            i++;
+            j++;
+        }
+    }
 }
 
 AnnotationsProxyModel::AnnotationsProxyModel(AnnotationsModel *sourceModel, QObject *parent)
@@ -251,7 +408,7 @@ AnnotationsWidget::AnnotationsWidget(MainWindow *main) :
 {
     ui->setupUi(this);
 
-    annotationsModel = new AnnotationsModel(&annotations, &nestedAnnotations, this);
+    annotationsModel = new AnnotationsModel(this);
     annotationsProxyModel = new AnnotationsProxyModel(annotationsModel, this);
     ui->AnnotationsTreeView->setModel(annotationsProxyModel);
     ui->AnnotationsTreeView->sortByColumn(AnnotationsModel::OffsetColumn, Qt::AscendingOrder);
@@ -278,6 +435,8 @@ AnnotationsWidget::AnnotationsWidget(MainWindow *main) :
             this, SLOT(showTitleContextMenu(const QPoint &)));
 
     connect(PPCore(), SIGNAL(annotationsChanged()), this, SLOT(refreshTree()));
+    // functions are regrouped after the file was disassembled again
+    connect(PPCore(), SIGNAL(stateChanged()), this, SLOT(refreshTree()));
     connect(Core(), SIGNAL(refreshAll()), this, SLOT(refreshTree()));
 }
 
@@ -345,23 +504,40 @@ void AnnotationsWidget::resizeEvent(QResizeEvent *event)
 
 void AnnotationsWidget::refreshTree()
 {
-    annotationsModel->beginReloadAnnotations();
-
-    annotations.clear();
-    annotations.reserve(PPCore()->getFile().annotations.size());
-    std::copy(PPCore()->getFile().annotations.begin(),
-              PPCore()->getFile().annotations.end(),
-              std::back_inserter(annotations));
-
-    nestedAnnotations.clear();
-    for (std::shared_ptr<Annotation> annotation : annotations) {
-        QString fcnName = Core()->cmdFunctionAt(annotation->address);
-        nestedAnnotations[fcnName].append(annotation);
+    if (!PPCore()->isReady())
+        return;
+
+    const PPBinaryFile &file = PPCore()->getFile();
+
+    std::vector<AnnotationsModel::Entry> entries;
+    entries.reserve(file.annotations.size());
+    for (const std::shared_ptr<Annotation> &annotation : file.getAnnotations())
+        entries.push_back({ annotation->address, annotation, QString() });
+    std::sort(entries.begin(), entries.end(), AnnotationsModel::entryLess);
+
+    // Resolve all functions in one sweep over pp's function index instead of asking r2
+    // for every single annotation
+    std::vector<AddressType> addresses;
+    addresses.reserve(entries.size());
+    for (const AnnotationsModel::Entry &entry : entries)
+        addresses.push_back(entry.address);
+    std::vector<::Function *> functions = file.getFunctionsAt(addresses);
+
+    ::Function *lastFunction = nullptr;
+    QString lastName;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (functions[i] != lastFunction) {
+            lastFunction = functions[i];
+            lastName = lastFunction ? QString::fromStdString(lastFunction->getJoinedName()) : QString();
+        }
+        entries[i].function = lastName;
     }
 
-    annotationsModel->endReloadAnnotations();
+    bool wasEmpty = annotationsModel->rowCount() == 0;
+    annotationsModel->setAnnotations(std::move(entries));
 
-    qhelpers::adjustColumns(ui->AnnotationsTreeView, 3, 0);
+    if (wasEmpty)
+        qhelpers::adjustColumns(ui->AnnotationsTreeView, 3, 0);
 }
 
 void AnnotationsWidget::setScrollMode()
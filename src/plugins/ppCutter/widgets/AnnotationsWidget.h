@@ -2,12 +2,14 @@
 #define ANNOTATIONSWIDGET_H
 
 #include <memory>
+#include <vector>
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
 
 #include "Cutter.h"
 #include "widgets/CutterDockWidget.h"
 
+#include "pp/types.h"
 #include "pp/annotations/Annotation.h"
 
 class MainWindow;
@@ -21,19 +23,44 @@ class AnnotationsModel : public QAbstractItemModel
 {
     Q_OBJECT
 
+public:
+    /**
+     * @brief Annotation together with the address and function it was listed under.
+     */
+    struct Entry {
+        AddressType address;
+        std::shared_ptr<Annotation> annotation;
+        QString function;
+    };
+
+    static bool entryLess(const Entry &a, const Entry &b);
+
 private:
-    QList<std::shared_ptr<Annotation>> *annotations;
-    QMap<QString, QList<std::shared_ptr<Annotation>>> *nestedAnnotations;
+    /**
+     * @brief Annotations of one function in the nested layout.
+     */
+    struct Group {
+        QString function;
+        std::vector<Entry> entries;     // sorted by entryLess
+    };
+
+    static const size_t fetchBatchSize = 256;
+
+    std::vector<Entry> annotations;     // sorted by entryLess
+    std::vector<Group> groups;          // sorted by function name
+    size_t fetchedGroups;               // groups already shown in the nested layout
     bool nested;
 
+    void updateEntries(const QModelIndex &parent, std::vector<Entry> &current,
+                       std::vector<Entry> entries, bool notify);
+    void updateGroups(std::vector<Group> newGroups);
+
 public:
     enum Column { OffsetColumn = 0, FunctionColumn, TypeColumn, DataColumn, ColumnCount };
     enum NestedColumn { OffsetNestedColumn = 0, TypeNestedColumn, DataNestedColumn, NestedColumnCount };
     enum Role { OffsetRole = Qt::UserRole, AnnotationDescriptionRole };
 
-    AnnotationsModel(QList<std::shared_ptr<Annotation>> *annotations,
-            QMap<QString, QList<std::shared_ptr<Annotation>>> *nestedAnnotations,
-            QObject *parent = nullptr);
+    AnnotationsModel(QObject *parent = nullptr);
 
     QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
     QModelIndex parent(const QModelIndex &index) const;
@@ -44,8 +71,14 @@ public:
     QVariant data(const QModelIndex &index, int role) const;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
 
-    void beginReloadAnnotations();
-    void endReloadAnnotations();
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    /**
+     * @brief Replaces the listed annotations, only inserting and removing the rows that differ.
+     * @param entries sorted by entryLess
+     */
+    void setAnnotations(std::vector<Entry> entries);
 
     bool isNested() const;
     void setNested(bool nested);
@@ -91,9 +124,6 @@ private:
     AnnotationsModel *annotationsModel;
     AnnotationsProxyModel *annotationsProxyModel;
 
-    QList<std::shared_ptr<Annotation>> annotations;
-    QMap<QString, QList<std::shared_ptr<Annotation>>> nestedAnnotations;
-
     void setScrollMode();
 };
 
@@ -30,6 +30,7 @@
 #include <QApplication>
 #include <QAction>
 
+#include <algorithm>
 #include <cmath>
 
 #include "Cutter.h"
@@ -96,6 +97,10 @@ PPGraphView::PPGraphView(QWidget *parent, CutterSeekable *seekable, MainWindow *
     connect(Core(), SIGNAL(functionsChanged()), this, SLOT(refreshView()));
     connect(Core(), SIGNAL(asmOptionsChanged()), this, SLOT(refreshView()));
     connect(Core(), SIGNAL(refreshCodeViews()), this, SLOT(refreshView()));
+    connect(Core(), &CutterCore::breakpointsChanged, this, [this]() {
+        setCacheDirty();
+        viewport()->update();
+    });
 
     connectSeekChanged(false);
 
@@ -186,8 +191,8 @@ PPGraphView::PPGraphView(QWidget *parent, CutterSeekable *seekable, MainWindow *
     layout->setAlignment(Qt::AlignTop);
 
     this->scale_thickness_multiplier = true;
-    connect(PPCore(), SIGNAL(annotationsChanged()), this, SLOT(refreshSeek()));
-    connect(PPCore(), SIGNAL(stateChanged()), this, SLOT(refreshView()));
+    connect(PPCore(), &PPCutterCore::annotationsChanged, this, &PPGraphView::onPPChanged);
+    connect(PPCore(), &PPCutterCore::stateChanged, this, &PPGraphView::onPPChanged);
 }
 
 void PPGraphView::connectSeekChanged(bool disconn)
@@ -199,8 +204,28 @@ void PPGraphView::connectSeekChanged(bool disconn)
     }
 }
 
+GraphLayoutTask::GraphLayoutTask(std::shared_ptr<const GraphLayout> layout,
+                                 GraphLayout::Graph graph, ut64 entry, quint64 generation)
+    : layout(std::move(layout)),
+      graph(std::move(graph)),
+      entry(entry),
+      generation(generation)
+{
+}
+
+void GraphLayoutTask::runTask()
+{
+    if (isInterrupted()) {
+        return;
+    }
+    layout->CalculateLayout(graph, entry, width, height);
+}
+
 PPGraphView::~PPGraphView()
 {
+    if (layoutTask) {
+        layoutTask->interrupt();
+    }
     for (QShortcut *shortcut : shortcuts) {
         delete shortcut;
     }
@@ -222,8 +247,17 @@ void PPGraphView::loadCurrentGraph()
     .set("asm.lines.fcn", false);
 
     disassembly_blocks.clear();
+    instrIndex.clear();
     blocks.clear();
 
+    // whatever is still being laid out belongs to the previous graph
+    graphGeneration++;
+    if (layoutTask) {
+        layoutTask->interrupt();
+        layoutTask.reset();
+    }
+    setPlaceholderText(QString());
+
     if (!PPCore()->isReady())
         return;
 
@@ -255,6 +289,14 @@ void PPGraphView::loadCurrentGraph()
 
     setEntry(f.entry);
 
+    // lines are cached with the palette's text color baked in
+    if (instructionLineColor != palette().text().color()) {
+        instructionLineCache.clear();
+        instructionLineColor = palette().text().color();
+    }
+
+    int blockLength = Core()->getRenderConfig()->graphBlockLength();
+
     for (auto& bb : PPCore()->getBasicBlocksOfFunction(*ppFunction, f.entry, false))
     {
         // get address of first instruction (= address of block)
@@ -284,15 +326,10 @@ void PPGraphView::loadCurrentGraph()
             i.addr = block_entry;
             i.size = 1;
 
-            std::string titles = "<font color='#44f'>Entry Point: " + entrypoint.name + "</font>";
-            QString text = QString::fromUtf8(titles.c_str());
-
-            QTextDocument textDoc;
-            textDoc.setHtml(text);
-            RichTextPainter::List richText = RichTextPainter::fromTextDocument(textDoc);
-            bool cropped;
-            int blockLength = Config()->getGraphBlockMaxChars() + Core()->getConfigb("asm.bytes") * 24 + Core()->getConfigb("asm.emu") * 10;
-            i.text = Text(RichTextPainter::cropped(richText, blockLength, "...", &cropped));
+            RichTextPainter::List richText;
+            appendRichText(richText, "Entry Point: " + QString::fromStdString(entrypoint.name),
+                           QColor("#44f"));
+            i.text = Text(RichTextPainter::cropped(richText, blockLength, "..."));
             i.fullText = Text();
             db.instrs.push_back(i);
         }
@@ -303,64 +340,14 @@ void PPGraphView::loadCurrentGraph()
             Instr i;
             i.addr = di.address;
 
-            const PPBinaryFile& f = PPCore()->getFile();
-
-            int size = f.getState().archInfo.getInstructionSize(di.instruction);
+            int size = file.getState().archInfo.getInstructionSize(di.instruction);
 
             // Skip last byte, otherwise it will overlap with next instruction
             i.size = size - 1;
 
-            QString textColor = palette().text().color().name();
-            QString color = (di.type == 1) ? textColor : instructionColors[di.type];
-
-            bool annotated = false;
-            if (f.getState().annotations_by_address.count(di.address))
-                annotated = f.getState().annotations_by_address.at(di.address).size() != 0;
-            std::string asmString = PPCore()->getObjDis().getInfo().printInstrunction(di.instruction);
-            QString asmQString = QString::fromUtf8(asmString.c_str());
-
-            BinaryDataViewType instBytes = f.getState().getData(di.address, size);
-
-            QString qbytes = "";
-
-            for (int b = 0; b < size; b++)
-                qbytes += QString("%1").arg((quint8)instBytes[b], 2, 16, QChar('0'));
-
-            qbytes = qbytes.leftJustified(2*6, ' '); // 6 bytes maximum
-            qbytes = qbytes.replace(" ", "&nbsp;");
-
-            QString comment = "";
-            if (di.type != InstructionType::SEQUENTIAL)
-                comment = QString(" (%1)").arg(QString::fromStdString(toString(di.type)).trimmed());
-
-
-            QString states = QString::fromStdString(PPCore()->getFile().getStates(di.address));
-
-            QString qCPE = "";
-            if (CERTAIN == PPCore()->getObjDis().getInfo().isConstantLoad(di.instruction)) {
-                DisassemblerState& ds = const_cast<DisassemblerState&>(PPCore()->getState());
-                const ConstantPoolEntry & cpe = PPCore()->getObjDis().getInfo().extractConstant(ds, di);
-                qCPE = "<font color='#ff7878'> ; = " + PPCore()->addrToString(cpe.value) + "</font>";
-            }
-
-            QString disas = QString("<font color='%10'>%1%2&nbsp;%8</font>&nbsp;<font color='%4'>%6&nbsp;&nbsp;%3%5%9")
-                    .arg(di.address, 8, 16, QChar('0'))
-                    .arg(annotated ? "*" : "&nbsp;")
-                    .arg(asmQString)
-                    .arg(color)
-                    .arg(comment)
-                    .arg(states.replace(" ", "&nbsp;"))
-                    .arg(qbytes)
-                    .arg(qCPE)
-                    .arg(textColor);
-
-            QTextDocument textDoc;
-            textDoc.setHtml(disas);
-
-            RichTextPainter::List richText = RichTextPainter::fromTextDocument(textDoc);
+            const RichTextPainter::List &richText = getInstructionLine(di);
 
             bool cropped;
-            int blockLength = Config()->getGraphBlockMaxChars() + Core()->getConfigb("asm.bytes") * 24 + Core()->getConfigb("asm.emu") * 10;
             i.text = Text(RichTextPainter::cropped(richText, blockLength, "...", &cropped));
             if(cropped)
                 i.fullText = richText;
@@ -455,10 +442,152 @@ void PPGraphView::loadCurrentGraph()
         addBlock(gb);
     }*/
     cleanupEdges(blocks);
+    buildInstrIndex();
 
     if (!disassembly_blocks.empty()) {
+        startLayoutTask(f.entry);
+    }
+}
+
+void PPGraphView::startLayoutTask(ut64 entry)
+{
+    if (!getGraphLayout().isThreadSafe()) {
+        // e.g. graphviz, which must not run concurrently with the layouts of other views
         computeGraphPlacement();
+        showSeekedBlock();
+        return;
+    }
+
+    // the blocks are only shown once they have been placed
+    GraphLayout::Graph graph;
+    graph.swap(blocks);
+    invalidateSpatialIndex();
+    setCacheDirty();
+    viewport()->update();
+    setPlaceholderText(tr("Computing graph layout..."));
+
+    layoutTask.reset(new GraphLayoutTask(sharedGraphLayout(), std::move(graph), entry,
+                                         graphGeneration));
+    GraphLayoutTask *task = layoutTask.data();
+    connect(task, &AsyncTask::finished, this, [this, task]() {
+        layoutTaskFinished(task);
+    }, Qt::QueuedConnection);
+    Core()->getAsyncTaskManager()->start(layoutTask);
+}
+
+void PPGraphView::layoutTaskFinished(GraphLayoutTask *task)
+{
+    if (task != layoutTask.data() || task->getGeneration() != graphGeneration
+            || task->isInterrupted()) {
+        // stale layout of a graph that was replaced in the meantime
+        return;
+    }
+
+    blocks.swap(task->getGraph());
+    invalidateSpatialIndex();
+    width = task->getWidth();
+    height = task->getHeight();
+    layoutTask.reset();
+    setPlaceholderText(QString());
+
+    setCacheDirty();
+    clampViewOffset();
+    viewport()->update();
+    showSeekedBlock();
+}
+
+void PPGraphView::showSeekedBlock()
+{
+    DisassemblyBlock *db = blockForAddress(seekable->getOffset());
+    if (db) {
+        transition_dont_seek = true;
+        showBlock(blocks[db->entry]);
+        showInstruction(blocks[db->entry], seekable->getOffset());
+    }
+}
+
+void PPGraphView::setPlaceholderText(const QString &text)
+{
+    if (text.isEmpty()) {
+        if (emptyText) {
+            emptyText->setVisible(false);
+        }
+        return;
+    }
+    if (!emptyText) {
+        emptyText = new QLabel(this);
+        emptyText->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
+        layout()->addWidget(emptyText);
+        layout()->setAlignment(emptyText, Qt::AlignHCenter);
     }
+    emptyText->setText(text);
+    emptyText->setVisible(true);
+}
+
+const RichTextPainter::List &PPGraphView::getInstructionLine(const DecodedInstruction &di)
+{
+    auto cached = instructionLineCache.find(di.address);
+    if (cached != instructionLineCache.end()) {
+        return cached->second;
+    }
+
+    const PPBinaryFile& f = PPCore()->getFile();
+
+    int size = f.getState().archInfo.getInstructionSize(di.instruction);
+
+    QColor textColor = instructionLineColor;
+    QColor color = (di.type == 1) ? textColor : QColor(instructionColors[di.type]);
+
+    bool annotated = !f.getAnnotationsAt(di.address).empty();
+    std::string asmString = PPCore()->getObjDis().getInfo().printInstrunction(di.instruction);
+
+    BinaryDataViewType instBytes = f.getState().getData(di.address, size);
+
+    QString qbytes;
+    for (int b = 0; b < size; b++)
+        qbytes += QString("%1").arg((quint8)instBytes[b], 2, 16, QChar('0'));
+    qbytes = qbytes.leftJustified(2*6, ' '); // 6 bytes maximum
+
+    QString comment;
+    if (di.type != InstructionType::SEQUENTIAL)
+        comment = QString(" (%1)").arg(QString::fromStdString(toString(di.type)).trimmed());
+
+    QString states = QString::fromStdString(f.getStates(di.address));
+
+    RichTextPainter::List &richText = instructionLineCache[di.address];
+    appendRichText(richText, QString("%1").arg(di.address, 8, 16, QChar('0'))
+                   + (annotated ? "*" : " ") + " " + qbytes, textColor);
+    appendRichText(richText, " ", textColor);
+    appendRichText(richText, states + "  " + QString::fromStdString(asmString) + comment, color);
+
+    if (CERTAIN == PPCore()->getObjDis().getInfo().isConstantLoad(di.instruction)) {
+        DisassemblerState& ds = const_cast<DisassemblerState&>(PPCore()->getState());
+        const ConstantPoolEntry & cpe = PPCore()->getObjDis().getInfo().extractConstant(ds, di);
+        appendRichText(richText, " ; = " + PPCore()->addrToString(cpe.value), QColor("#ff7878"));
+    }
+
+    return richText;
+}
+
+void PPGraphView::appendRichText(RichTextPainter::List &richText, const QString &text,
+                                 const QColor &color)
+{
+    RichTextPainter::CustomRichText_t rt;
+    rt.text = text;
+    rt.textColor = color;
+    rt.flags = RichTextPainter::FlagColor;
+    richText.push_back(rt);
+}
+
+void PPGraphView::invalidateInstructionLines()
+{
+    instructionLineCache.clear();
+}
+
+void PPGraphView::onPPChanged()
+{
+    invalidateInstructionLines();
+    refreshView();
 }
 
 PPGraphView::EdgeConfigurationMapping PPGraphView::getEdgeConfigurations()
@@ -500,6 +629,18 @@ void PPGraphView::prepareGraphNode(GraphBlock &block)
     block.height = (height * charHeight) + extra;
 }
 
+void PPGraphView::drawBlockOverview(QPainter &p, GraphView::GraphBlock &block)
+{
+    RVA addr = seekable->getOffset();
+    bool selected = false;
+    DisassemblyBlock *db = blockForAddress(addr);
+    selected = db && db->entry == block.entry;
+
+    p.setPen(QPen(graphNodeColor, 0));
+    p.setBrush(selected ? disassemblySelectedBackgroundColor : disassemblyBackgroundColor);
+    p.drawRect(QRectF(block.x, block.y, block.width, block.height));
+}
+
 void PPGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive)
 {
     QRectF blockRect(block.x, block.y, block.width, block.height);
@@ -814,38 +955,67 @@ void PPGraphView::showInstruction(GraphView::GraphBlock &block, RVA addr)
     showRectangle(QRect(rect.x(), rect.y(), rect.width(), rect.height()), true);
 }
 
-PPGraphView::DisassemblyBlock *PPGraphView::blockForAddress(RVA addr)
+void PPGraphView::buildInstrIndex()
 {
+    instrIndex.clear();
+    instrIndexMaxSize = 0;
     for (auto &blockIt : disassembly_blocks) {
         DisassemblyBlock &db = blockIt.second;
-        for (const Instr &i : db.instrs) {
-            if (i.addr == RVA_INVALID || i.size == RVA_INVALID) {
+        for (size_t i = 0; i < db.instrs.size(); i++) {
+            const Instr &instr = db.instrs[i];
+            if (instr.addr == RVA_INVALID || instr.size == RVA_INVALID || instr.empty()) {
                 continue;
             }
-
-            if (i.contains(addr)) {
-                return &db;
-            }
+            instrIndex.push_back({instr.addr, &db, i});
+            instrIndexMaxSize = std::max(instrIndexMaxSize, instr.size);
         }
     }
-    return nullptr;
+    // Lookups scan backwards from the end of an address, so of several entries with the same address
+    // the one sorted last wins. Sort those by descending position within their block, so the entry
+    // point header wins over the first instruction of the block, like it did in a linear search.
+    std::stable_sort(instrIndex.begin(), instrIndex.end(),
+    [](const InstrIndexEntry & a, const InstrIndexEntry & b) {
+        if (a.addr != b.addr) {
+            return a.addr < b.addr;
+        }
+        if (a.block->entry != b.block->entry) {
+            return a.block->entry < b.block->entry;
+        }
+        return a.instr > b.instr;
+    });
 }
 
-const PPGraphView::Instr *PPGraphView::instrForAddress(RVA addr)
+const PPGraphView::InstrIndexEntry *PPGraphView::findInstrIndexEntry(RVA addr) const
 {
-    DisassemblyBlock *block = blockForAddress(addr);
-    for (const Instr &i : block->instrs) {
-        if (i.addr == RVA_INVALID || i.size == RVA_INVALID) {
-            continue;
+    auto it = std::upper_bound(instrIndex.begin(), instrIndex.end(), addr,
+    [](RVA addr, const InstrIndexEntry & entry) {
+        return addr < entry.addr;
+    });
+    // only instructions starting less than the largest instruction size before addr can contain it
+    while (it != instrIndex.begin()) {
+        --it;
+        if (addr - it->addr >= instrIndexMaxSize) {
+            break;
         }
-
-        if (i.contains(addr)) {
-            return &i;
+        if (it->block->instrs[it->instr].contains(addr)) {
+            return &*it;
         }
     }
     return nullptr;
 }
 
+PPGraphView::DisassemblyBlock *PPGraphView::blockForAddress(RVA addr)
+{
+    const InstrIndexEntry *entry = findInstrIndexEntry(addr);
+    return entry ? entry->block : nullptr;
+}
+
+const PPGraphView::Instr *PPGraphView::instrForAddress(RVA addr)
+{
+    const InstrIndexEntry *entry = findInstrIndexEntry(addr);
+    return entry ? &entry->block->instrs[entry->instr] : nullptr;
+}
+
 void PPGraphView::onSeekChanged(RVA addr)
 {
     blockMenu->setOffset(addr);
@@ -857,7 +1027,7 @@ void PPGraphView::onSeekChanged(RVA addr)
         db = blockForAddress(addr);
         switchFunction = true;
     }
-    if (db) {
+    if (db && !layoutTask) {
         // This is a local address! We animated to it.
         transition_dont_seek = true;
         showBlock(blocks[db->entry], !switchFunction);
@@ -875,8 +1045,12 @@ void PPGraphView::takeTrue()
 
     if (db->true_path != RVA_INVALID) {
         seekable->seek(db->true_path);
-    } else if (!blocks[db->entry].edges.empty()) {
-        seekable->seek(blocks[db->entry].edges[0].target);
+        return;
+    }
+    // blocks is empty while a layout task is running
+    auto it = blocks.find(db->entry);
+    if (it != blocks.end() && !it->second.edges.empty()) {
+        seekable->seek(it->second.edges[0].target);
     }
 }
 
@@ -889,8 +1063,12 @@ void PPGraphView::takeFalse()
 
     if (db->false_path != RVA_INVALID) {
         seekable->seek(db->false_path);
-    } else if (!blocks[db->entry].edges.empty()) {
-        seekable->seek(blocks[db->entry].edges[0].target);
+        return;
+    }
+    // blocks is empty while a layout task is running
+    auto it = blocks.find(db->entry);
+    if (it != blocks.end() && !it->second.edges.empty()) {
+        seekable->seek(it->second.edges[0].target);
     }
 }
 
@@ -939,7 +1117,10 @@ void PPGraphView::seekLocal(RVA addr, bool update_viewport)
     }
     connectSeekChanged(true);
     seekable->seek(addr);
-    associatedAddresses = PPCore()->getFile().getAssociatedAddresses(addr);
+    if (PPCore()->isReady())
+        associatedAddresses = PPCore()->getFile().getAssociatedAddresses(addr);
+    else
+        associatedAddresses.clear();
     connectSeekChanged(false);
     if (update_viewport) {
         viewport()->update();
@@ -1133,11 +1314,46 @@ void PPGraphView::restoreCurrentBlock()
 
 void PPGraphView::paintEvent(QPaintEvent *event)
 {
-    // PPGraphView is always dirty
-    setCacheDirty();
+    // only rerender the blocks whose selection changed since the last frame
+    RVA seekAddr = seekable->getOffset();
+    RVA pcAddr = Core()->getProgramCounterValue();
+    if (seekAddr != paintedSeekAddr || pcAddr != paintedPCAddr) {
+        invalidateAddressTiles(paintedSeekAddr);
+        invalidateAddressTiles(paintedPCAddr);
+        invalidateAddressTiles(seekAddr);
+        invalidateAddressTiles(pcAddr);
+        paintedSeekAddr = seekAddr;
+        paintedPCAddr = pcAddr;
+    }
+    if (associatedAddresses != paintedAssociatedAddresses) {
+        // associated addresses are usually in other blocks than the seek
+        for (AddressType addr : paintedAssociatedAddresses) {
+            invalidateAddressTiles(addr);
+        }
+        for (AddressType addr : associatedAddresses) {
+            invalidateAddressTiles(addr);
+        }
+        paintedAssociatedAddresses = associatedAddresses;
+    }
+    QString token = highlight_token ? highlight_token->content : QString();
+    if (token != paintedHighlightToken) {
+        // the token may occur in any block
+        setCacheDirty();
+        paintedHighlightToken = token;
+    }
     GraphView::paintEvent(event);
 }
 
+void PPGraphView::invalidateAddressTiles(RVA addr)
+{
+    if (addr == RVA_INVALID) {
+        return;
+    }
+    if (DisassemblyBlock *db = blockForAddress(addr)) {
+        invalidateBlockTiles(db->entry);
+    }
+}
+
 bool PPGraphView::Instr::contains(ut64 addr) const
 {
     return this->addr <= addr && (addr - this->addr) < size;
@@ -12,6 +12,7 @@
 #include "menus/DisassemblyContextMenu.h"
 #include "common/RichTextPainter.h"
 #include "common/CutterSeekable.h"
+#include "common/AsyncTask.h"
 
 #include <vector>
 #include <set>
@@ -22,6 +23,37 @@
 class QTextEdit;
 class FallbackSyntaxHighlighter;
 
+/**
+ * @brief Computes the placement of a graph on the AsyncTaskManager thread pool. Only used
+ * for layouts that are thread safe, see GraphLayout::isThreadSafe().
+ */
+class GraphLayoutTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    GraphLayoutTask(std::shared_ptr<const GraphLayout> layout, GraphLayout::Graph graph,
+                    ut64 entry, quint64 generation);
+
+    QString getTitle() override { return tr("Graph layout"); }
+
+    quint64 getGeneration() const       { return generation; }
+    GraphLayout::Graph &getGraph()      { return graph; }
+    int getWidth() const                { return width; }
+    int getHeight() const               { return height; }
+
+protected:
+    void runTask() override;
+
+private:
+    std::shared_ptr<const GraphLayout> layout;
+    GraphLayout::Graph graph;
+    ut64 entry;
+    quint64 generation;
+    int width = 0;
+    int height = 0;
+};
+
 class PPGraphView : public CutterGraphView
 {
     Q_OBJECT
@@ -124,6 +156,7 @@ public:
     ~PPGraphView() override;
     std::unordered_map<ut64, DisassemblyBlock> disassembly_blocks;
     virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive) override;
+    void drawBlockOverview(QPainter &p, GraphView::GraphBlock &block) override;
     virtual void blockClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos) override;
     virtual void blockDoubleClicked(GraphView::GraphBlock &block, QMouseEvent *event,
                                     QPoint pos) override;
@@ -161,6 +194,12 @@ public slots:
 
     void copySelection();
 
+    /**
+     * @brief Drop the pre-rendered instruction lines, they depend on
+     * annotations, disassembly and calculated states.
+     */
+    void invalidateInstructionLines();
+
 protected:
     void paintEvent(QPaintEvent *event) override;
     void blockContextMenuRequested(GraphView::GraphBlock &block, QContextMenuEvent *event,
@@ -169,6 +208,7 @@ protected:
     void restoreCurrentBlock() override;
 private slots:
     void showExportDialog() override;
+    void onPPChanged();
     void onActionHighlightBITriggered();
     void onActionUnhighlightBITriggered();
 
@@ -176,6 +216,9 @@ private:
     bool transition_dont_seek = false;
 
     Token *highlight_token;
+    RVA paintedSeekAddr = RVA_INVALID;
+    RVA paintedPCAddr = RVA_INVALID;
+    QString paintedHighlightToken;
     bool emptyGraph;
     ut64 currentBlockAddress = RVA_INVALID;
 
@@ -185,10 +228,44 @@ private:
     MainWindow *main;
     static std::vector<QString> instructionColors;
     std::set<AddressType> associatedAddresses;
+    std::set<AddressType> paintedAssociatedAddresses;
 
     void connectSeekChanged(bool disconnect);
 
     void prepareGraphNode(GraphBlock &block);
+
+    /**
+     * @brief Incremented for every graph that is loaded, layouts finishing for an older
+     * generation are discarded.
+     */
+    quint64 graphGeneration = 0;
+    QSharedPointer<GraphLayoutTask> layoutTask;
+    void startLayoutTask(ut64 entry);
+    void layoutTaskFinished(GraphLayoutTask *task);
+    void showSeekedBlock();
+    void setPlaceholderText(const QString &text);
+
+    /**
+     * @brief Rich text of an instruction line before cropping, cached by address.
+     */
+    const RichTextPainter::List &getInstructionLine(const DecodedInstruction &di);
+    static void appendRichText(RichTextPainter::List &richText, const QString &text,
+                               const QColor &color);
+    std::unordered_map<ut64, RichTextPainter::List> instructionLineCache;
+    QColor instructionLineColor;
+
+    /**
+     * @brief Every instruction of disassembly_blocks sorted by address, rebuilt by loadCurrentGraph().
+     */
+    struct InstrIndexEntry {
+        RVA addr;
+        DisassemblyBlock *block;
+        size_t instr;
+    };
+    std::vector<InstrIndexEntry> instrIndex;
+    ut64 instrIndexMaxSize = 0;
+    void buildInstrIndex();
+    const InstrIndexEntry *findInstrIndexEntry(RVA addr) const;
     Token *getToken(Instr *instr, int x);
 
     QPoint getInstructionOffset(const DisassemblyBlock &block, int line) const;
@@ -205,6 +282,7 @@ private:
     void showInstruction(GraphView::GraphBlock &block, RVA addr);
     const Instr *instrForAddress(RVA addr);
     DisassemblyBlock *blockForAddress(RVA addr);
+    void invalidateAddressTiles(RVA addr);
     void seekLocal(RVA addr, bool update_viewport = true);
     void seekInstruction(bool previous_instr);
 
@@ -15,6 +15,7 @@
 #include "common/Helpers.h"
 #include "common/SvgIconEngine.h"
 #include "WidgetShortcuts.h"
+#include "HexWidget.h"
 
 #ifdef Q_OS_WIN
 #include <io.h>
@@ -237,6 +238,9 @@ void ConsoleWidget::executeCommand(const QString &command)
         ui->r2InputLineEdit->setEnabled(true);
         ui->r2InputLineEdit->setFocus();
 
+        // the command may have written anywhere
+        MemoryBlockCache::instance().clear();
+
         if (oldOffset != Core()->getOffset()) {
             Core()->updateSeek();
         }
@@ -234,6 +234,8 @@ void CutterGraphView::refreshView()
 {
     initFont();
     setLayoutConfig(getLayoutConfig());
+    // fonts, colors or highlights may have changed
+    setCacheDirty();
 }
 
 
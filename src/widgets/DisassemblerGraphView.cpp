@@ -51,6 +51,10 @@ DisassemblerGraphView::DisassemblerGraphView(QWidget *parent, CutterSeekable *se
     connect(Core(), SIGNAL(functionsChanged()), this, SLOT(refreshView()));
     connect(Core(), SIGNAL(asmOptionsChanged()), this, SLOT(refreshView()));
     connect(Core(), SIGNAL(refreshCodeViews()), this, SLOT(refreshView()));
+    connect(Core(), &CutterCore::breakpointsChanged, this, [this]() {
+        setCacheDirty();
+        viewport()->update();
+    });
 
     connectSeekChanged(false);
 
@@ -224,6 +228,7 @@ void DisassemblerGraphView::loadCurrentGraph()
     RVA entry = func["offset"].toVariant().toULongLong();
 
     setEntry(entry);
+    auto renderConfig = Core()->getRenderConfig();
     for (const QJsonValueRef &value : func["blocks"].toArray()) {
         QJsonObject block = value.toObject();
         RVA block_entry = block["offset"].toVariant().toULongLong();
@@ -286,8 +291,7 @@ void DisassemblerGraphView::loadCurrentGraph()
             //Colors::colorizeAssembly(richText, textDoc.toPlainText(), 0);
 
             bool cropped;
-            int blockLength = Config()->getGraphBlockMaxChars() + Core()->getConfigb("asm.bytes") * 24 +
-                              Core()->getConfigb("asm.emu") * 10;
+            int blockLength = renderConfig->graphBlockLength();
             i.text = Text(RichTextPainter::cropped(richText, blockLength, "...", &cropped));
             if (cropped)
                 i.fullText = richText;
@@ -346,6 +350,25 @@ void DisassemblerGraphView::prepareGraphNode(GraphBlock &block)
     block.height = (height * charHeight) + extra;
 }
 
+void DisassemblerGraphView::drawBlockOverview(QPainter &p, GraphView::GraphBlock &block)
+{
+    RVA addr = seekable->getOffset();
+    bool selected = false;
+    auto blockIt = disassembly_blocks.find(block.entry);
+    if (blockIt != disassembly_blocks.end()) {
+        for (const Instr &instr : blockIt->second.instrs) {
+            if (instr.contains(addr)) {
+                selected = true;
+                break;
+            }
+        }
+    }
+
+    p.setPen(QPen(graphNodeColor, 0));
+    p.setBrush(selected ? disassemblySelectedBackgroundColor : disassemblyBackgroundColor);
+    p.drawRect(QRectF(block.x, block.y, block.width, block.height));
+}
+
 void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive)
 {
     QRectF blockRect(block.x, block.y, block.width, block.height);
@@ -941,11 +964,36 @@ void DisassemblerGraphView::restoreCurrentBlock()
 
 void DisassemblerGraphView::paintEvent(QPaintEvent *event)
 {
-    // DisassemblerGraphView is always dirty
-    setCacheDirty();
+    // only rerender the blocks whose selection changed since the last frame
+    RVA seekAddr = seekable->getOffset();
+    RVA pcAddr = Core()->getProgramCounterValue();
+    if (seekAddr != paintedSeekAddr || pcAddr != paintedPCAddr) {
+        invalidateAddressTiles(paintedSeekAddr);
+        invalidateAddressTiles(paintedPCAddr);
+        invalidateAddressTiles(seekAddr);
+        invalidateAddressTiles(pcAddr);
+        paintedSeekAddr = seekAddr;
+        paintedPCAddr = pcAddr;
+    }
+    QString token = highlight_token ? highlight_token->content : QString();
+    if (token != paintedHighlightToken) {
+        // the token may occur in any block
+        setCacheDirty();
+        paintedHighlightToken = token;
+    }
     GraphView::paintEvent(event);
 }
 
+void DisassemblerGraphView::invalidateAddressTiles(RVA addr)
+{
+    if (addr == RVA_INVALID) {
+        return;
+    }
+    if (DisassemblyBlock *db = blockForAddress(addr)) {
+        invalidateBlockTiles(db->entry);
+    }
+}
+
 bool DisassemblerGraphView::Instr::contains(ut64 addr) const
 {
     return this->addr <= addr && (addr - this->addr) < size;
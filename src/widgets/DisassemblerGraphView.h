@@ -92,6 +92,7 @@ public:
     ~DisassemblerGraphView() override;
     std::unordered_map<ut64, DisassemblyBlock> disassembly_blocks;
     virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive) override;
+    void drawBlockOverview(QPainter &p, GraphView::GraphBlock &block) override;
     virtual void blockClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos) override;
     virtual void blockDoubleClicked(GraphView::GraphBlock &block, QMouseEvent *event,
                                     QPoint pos) override;
@@ -144,6 +145,9 @@ private:
     bool transition_dont_seek = false;
 
     Token *highlight_token;
+    RVA paintedSeekAddr = RVA_INVALID;
+    RVA paintedPCAddr = RVA_INVALID;
+    QString paintedHighlightToken;
     bool emptyGraph;
     ut64 currentBlockAddress = RVA_INVALID;
 
@@ -169,6 +173,7 @@ private:
     void showInstruction(GraphView::GraphBlock &block, RVA addr);
     const Instr *instrForAddress(RVA addr);
     DisassemblyBlock *blockForAddress(RVA addr);
+    void invalidateAddressTiles(RVA addr);
     void seekLocal(RVA addr, bool update_viewport = true);
     void seekInstruction(bool previous_instr);
 
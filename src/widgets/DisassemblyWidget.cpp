@@ -16,6 +16,7 @@
 #include <QPainter>
 #include <QPainterPath>
 #include <QSplitter>
+#include <QSet>
 
 
 class DisassemblyTextBlockUserData: public QTextBlockUserData
@@ -153,16 +154,24 @@ DisassemblyWidget::DisassemblyWidget(MainWindow *main)
     connect(Core(), SIGNAL(varsChanged()), this, SLOT(refreshDisasm()));
     connect(Core(), SIGNAL(asmOptionsChanged()), this, SLOT(refreshDisasm()));
     connect(Core(), &CutterCore::instructionChanged, this, [this](RVA offset) {
+        // a patch can change lines outside the view as well (e.g. the length of the
+        // patched instruction), so never keep the cache around
+        lineCache.clear();
         if (offset >= topOffset && offset <= bottomOffset) {
             refreshDisasm();
         }
     });
+    // the cached lines carry the program counter and register/stack references,
+    // refreshing in place drops them
+    connect(Core(), SIGNAL(registersChanged()), this, SLOT(refreshDisasm()));
+    connect(Core(), SIGNAL(stackChanged()), this, SLOT(refreshDisasm()));
     connect(Core(), SIGNAL(refreshCodeViews()), this, SLOT(refreshDisasm()));
 
     connect(Config(), &Configuration::fontsUpdated, this, &DisassemblyWidget::fontsUpdatedSlot);
     connect(Config(), &Configuration::colorsUpdated, this, &DisassemblyWidget::colorsUpdatedSlot);
 
     connect(Core(), &CutterCore::refreshAll, this, [this]() {
+        lineCache.clear();
         refreshDisasm(seekable->getOffset());
     });
     refreshDisasm(seekable->getOffset());
@@ -252,6 +261,11 @@ QList<DisassemblyLine> DisassemblyWidget::getLines()
 
 void DisassemblyWidget::refreshDisasm(RVA offset)
 {
+    if (offset == RVA_INVALID) {
+        // refreshing in place means the disassembly itself changed
+        lineCache.clear();
+    }
+
     if(!disasmRefresh->attemptRefresh(offset == RVA_INVALID ? nullptr : new RVA(offset))) {
         return;
     }
@@ -272,15 +286,18 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
     }
 
     breakpoints = Core()->getBreakpointsAddresses();
+    QSet<RVA> breakpointSet = QSet<RVA>::fromList(breakpoints);
     int horizontalScrollValue = mDisasTextEdit->horizontalScrollBar()->value();
     mDisasTextEdit->setLockScroll(true); // avoid flicker
 
-    // Retrieve disassembly lines
-    {
-        TempConfig tempConfig;
-        tempConfig.set("scr.color", COLOR_MODE_16M)
-		.set("asm.lines", false);
-        lines = Core()->disassembleLines(topOffset, maxLines);
+    // Retrieve disassembly lines, only those not cached yet are disassembled
+    int first = fillLineCache(topOffset, maxLines);
+    lines.clear();
+    for (int i = first; i >= 0 && i < static_cast<int>(lineCache.size()) && lines.size() < maxLines; i++) {
+        if (lineCache[i].line.offset < topOffset) { // overflow
+            break;
+        }
+        lines << lineCache[i].line;
     }
 
     connectCursorPositionChanged(true);
@@ -288,24 +305,30 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
     mDisasTextEdit->document()->clear();
     QTextCursor cursor(mDisasTextEdit->document());
     QTextBlockFormat regular = cursor.blockFormat();
-    for (const DisassemblyLine &line : lines) {
-        if (line.offset < topOffset) { // overflow
-            break;
+    QTextBlockFormat breakpointFormat;
+    breakpointFormat.setBackground(ConfigColor("gui.breakpoint_background"));
+    for (int i = 0; i < lines.size(); i++) {
+        if (i > 0) {
+            cursor.insertBlock(regular);
+        }
+        for (const RichTextPainter::CustomRichText_t &run : lineCache[first + i].richText) {
+            QTextCharFormat format;
+            if (run.flags == RichTextPainter::FlagColor || run.flags == RichTextPainter::FlagAll) {
+                format.setForeground(run.textColor);
+            }
+            if (run.flags == RichTextPainter::FlagBackground || run.flags == RichTextPainter::FlagAll) {
+                format.setBackground(run.textBackground);
+            }
+            cursor.insertText(run.text, format);
         }
-        cursor.insertHtml(line.text);
-        if (Core()->isBreakpoint(breakpoints, line.offset)) {
-            QTextBlockFormat f;
-            f.setBackground(ConfigColor("gui.breakpoint_background"));
-            cursor.setBlockFormat(f);
+        if (breakpointSet.contains(lines[i].offset)) {
+            cursor.setBlockFormat(breakpointFormat);
         }
-        auto a = new DisassemblyTextBlockUserData(line);
-        cursor.block().setUserData(a);
-        cursor.insertBlock();
-        cursor.setBlockFormat(regular);
+        cursor.block().setUserData(new DisassemblyTextBlockUserData(lines[i]));
     }
 
     if (!lines.isEmpty()) {
-        bottomOffset = lines[qMin(lines.size(), maxLines) - 1].offset;
+        bottomOffset = lines.last().offset;
         if (bottomOffset < topOffset) {
             bottomOffset = RVA_MAX;
         }
@@ -313,14 +336,6 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
         bottomOffset = topOffset;
     }
 
-    // remove additional lines
-    QTextCursor tc = mDisasTextEdit->textCursor();
-    tc.movePosition(QTextCursor::Start);
-    tc.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, maxLines - 1);
-    tc.movePosition(QTextCursor::EndOfLine);
-    tc.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
-    tc.removeSelectedText();
-
     connectCursorPositionChanged(false);
 
     updateCursorPosition();
@@ -332,6 +347,101 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
     leftPanel->update();
 }
 
+std::vector<DisassemblyWidget::CachedLine> DisassemblyWidget::fetchLines(RVA offset, int count)
+{
+    QList<DisassemblyLine> disassembly;
+    {
+        TempConfig tempConfig;
+        tempConfig.set("scr.color", COLOR_MODE_16M)
+        .set("asm.lines", false);
+        disassembly = Core()->disassembleLines(offset, count);
+    }
+
+    std::vector<CachedLine> result;
+    result.reserve(disassembly.size());
+    QTextDocument textDoc;
+    for (const DisassemblyLine &line : disassembly) {
+        if (line.offset < offset) { // overflow
+            break;
+        }
+        // parse the html once, refreshes only insert the runs
+        textDoc.setHtml(line.text);
+        result.push_back({ line, RichTextPainter::fromTextDocument(textDoc) });
+    }
+    return result;
+}
+
+/**
+ * @brief Make sure the cache has the lines at offset followed by at least count lines.
+ * @return index of the first line at offset in lineCache, -1 if there is none
+ */
+int DisassemblyWidget::fillLineCache(RVA offset, int count)
+{
+    auto findOffset = [this](RVA offset) -> int {
+        for (size_t i = 0; i < lineCache.size(); i++) {
+            if (lineCache[i].line.offset == offset) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    };
+
+    int first = findOffset(offset);
+    if (first < 0) {
+        std::vector<CachedLine> fetched = fetchLines(offset, count);
+        size_t joined = fetched.size();
+        if (!lineCache.empty() && offset < lineCache.front().line.offset) {
+            // scrolled up, keep the cached lines if the new ones lead into them
+            for (size_t i = 0; i < fetched.size(); i++) {
+                if (fetched[i].line.offset == lineCache.front().line.offset) {
+                    joined = i;
+                    break;
+                }
+            }
+        }
+        if (joined < fetched.size()) {
+            lineCache.insert(lineCache.begin(), fetched.begin(), fetched.begin() + joined);
+        } else {
+            lineCache.assign(fetched.begin(), fetched.end());
+        }
+        first = lineCache.empty() ? -1 : 0;
+    }
+    if (first < 0) {
+        return -1;
+    }
+
+    while (static_cast<int>(lineCache.size()) - first < count) {
+        // lines of the last offset may be incomplete, fetch them again together with the next ones
+        RVA lastOffset = lineCache.back().line.offset;
+        int groupStart = static_cast<int>(lineCache.size()) - 1;
+        while (groupStart > first && lineCache[groupStart - 1].line.offset == lastOffset) {
+            groupStart--;
+        }
+        int missing = count - (static_cast<int>(lineCache.size()) - first);
+        std::vector<CachedLine> fetched = fetchLines(lastOffset, missing + 1);
+        if (fetched.size() <= lineCache.size() - groupStart) {
+            break; // end of the address space
+        }
+        lineCache.erase(lineCache.begin() + groupStart, lineCache.end());
+        lineCache.insert(lineCache.end(), fetched.begin(), fetched.end());
+    }
+
+    // drop the lines farthest away from the visible ones
+    while (lineCache.size() > lineCacheMaxSize) {
+        int below = static_cast<int>(lineCache.size()) - first - count;
+        if (first > below) {
+            RVA frontOffset = lineCache.front().line.offset;
+            while (first > 0 && lineCache.front().line.offset == frontOffset) {
+                lineCache.pop_front();
+                first--;
+            }
+        } else {
+            lineCache.pop_back();
+        }
+    }
+
+    return first;
+}
 
 void DisassemblyWidget::scrollInstructions(int count)
 {
@@ -362,7 +472,7 @@ bool DisassemblyWidget::updateMaxLines()
 
     if (currentMaxLines != maxLines) {
         maxLines = currentMaxLines;
-        refreshDisasm();
+        refreshDisasm(topOffset);
         return true;
     }
 
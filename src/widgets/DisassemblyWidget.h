@@ -6,12 +6,15 @@
 #include "common/CutterSeekable.h"
 #include "common/RefreshDeferrer.h"
 #include "common/CachedFontMetrics.h"
+#include "common/RichTextPainter.h"
 
 #include <QTextEdit>
 #include <QPlainTextEdit>
 #include <QShortcut>
 #include <QAction>
 
+#include <deque>
+
 
 class DisassemblyTextEdit;
 class DisassemblyScrollArea;
@@ -77,6 +80,25 @@ private:
 
     QList<RVA> breakpoints;
 
+    /**
+     * @brief Decoded line with its text already split into colored runs.
+     */
+    struct CachedLine {
+        DisassemblyLine line;
+        RichTextPainter::List richText;
+    };
+
+    /**
+     * Consecutive lines around the visible ones, so scrolling and seeking nearby only
+     * disassembles the lines that weren't shown before. Always starts with the first line
+     * of an offset.
+     */
+    std::deque<CachedLine> lineCache;
+    static const size_t lineCacheMaxSize = 1024;
+
+    int fillLineCache(RVA offset, int count);
+    std::vector<CachedLine> fetchLines(RVA offset, int count);
+
     void setupFonts();
     void setupColors();
 
@@ -6,6 +6,12 @@
 #include <stack>
 #include <cassert>
 #include <queue>
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
 
 #include "common/BinaryTrees.h"
 
@@ -258,10 +264,115 @@ void GraphGridLayout::selectTree(GraphGridLayout::LayoutState &state)
     }
 }
 
-void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, int &width, int &height) const
+namespace {
+
+/**
+ * @brief Small LRU cache keyed by a structural description of the layout input. Layouts are
+ * computed both on the GUI thread and in background tasks, so access is serialized.
+ */
+template<typename T>
+class LayoutCache
 {
-    LayoutState layoutState;
-    layoutState.blocks = &blocks;
+public:
+    bool lookup(size_t hash, const std::vector<ut64> &key, T &result)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(hash);
+        if (it == index.end() || it->second->key != key) {
+            return false;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        result = it->second->value;
+        return true;
+    }
+
+    void insert(size_t hash, std::vector<ut64> key, T value, size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(hash);
+        if (it != index.end()) {
+            entries.erase(it->second);
+        }
+        entries.push_front({hash, std::move(key), std::move(value)});
+        index[hash] = entries.begin();
+        while (entries.size() > capacity) {
+            index.erase(entries.back().hash);
+            entries.pop_back();
+        }
+    }
+
+private:
+    struct Entry {
+        size_t hash;
+        std::vector<ut64> key;
+        T value;
+    };
+
+    std::mutex mutex;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<size_t, typename std::list<Entry>::iterator> index;
+};
+
+struct PlacedLayout {
+    /// laid out blocks in the order of the sorted block ids
+    std::vector<GraphLayout::GraphBlock> blocks;
+    int width = 0;
+    int height = 0;
+};
+
+size_t hashLayoutKey(const std::vector<ut64> &key)
+{
+    size_t hash = 0;
+    for (ut64 value : key) {
+        hash ^= std::hash<ut64>()(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+}
+
+std::vector<ut64> GraphGridLayout::layoutCacheKey(const GraphLayout::Graph &blocks, ut64 entry,
+                                                  bool includeHeights,
+                                                  std::vector<ut64> &blockIds) const
+{
+    blockIds.clear();
+    blockIds.reserve(blocks.size());
+    size_t edgeCount = 0;
+    for (const auto &blockIt : blocks) {
+        blockIds.push_back(blockIt.first);
+        edgeCount += blockIt.second.edges.size();
+    }
+    std::sort(blockIds.begin(), blockIds.end());
+
+    std::vector<ut64> key;
+    key.reserve(7 + blockIds.size() * 4 + edgeCount);
+    key.push_back(entry);
+    key.push_back(ut64(tightSubtreePlacement) | ut64(parentBetweenDirectChild) << 1
+                  | ut64(verticalBlockAlignmentMiddle) << 2 | ut64(useLayoutOptimization) << 3);
+    key.push_back(ut64(layoutConfig.blockVerticalSpacing));
+    key.push_back(ut64(layoutConfig.blockHorizontalSpacing));
+    key.push_back(ut64(layoutConfig.edgeVerticalSpacing));
+    key.push_back(ut64(layoutConfig.edgeHorizontalSpacing));
+    key.push_back(blockIds.size());
+    for (ut64 id : blockIds) {
+        const auto &block = blocks.at(id);
+        key.push_back(id);
+        key.push_back(ut64(uint32_t(block.width)) << 32
+                      | (includeHeights ? ut64(uint32_t(block.height)) : 0));
+        key.push_back(block.edges.size());
+        for (const auto &edge : block.edges) {
+            key.push_back(edge.target);
+        }
+    }
+    return key;
+}
+
+void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, int &width,
+                                      int &height) const
+{
+    static LayoutCache<PlacedLayout> placedLayouts;
+    static LayoutCache<LayoutState> gridLayouts;
+
     if (blocks.empty()) {
         return;
     }
@@ -269,6 +380,48 @@ void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, in
         entry = blocks.begin()->first;
     }
 
+    std::vector<ut64> blockIds;
+    std::vector<ut64> key = layoutCacheKey(blocks, entry, true, blockIds);
+    size_t hash = hashLayoutKey(key);
+    PlacedLayout placed;
+    if (placedLayouts.lookup(hash, key, placed)) {
+        for (size_t i = 0; i < blockIds.size(); i++) {
+            auto &block = blocks[blockIds[i]];
+            block.x = placed.blocks[i].x;
+            block.y = placed.blocks[i].y;
+            block.edges = std::move(placed.blocks[i].edges);
+        }
+        width = placed.width;
+        height = placed.height;
+        return;
+    }
+
+    // Grid placement and rough edge routing don't depend on block heights, when only those
+    // changed (e.g. a line was added to a block) just the pixel placement has to be redone.
+    std::vector<ut64> gridKey = layoutCacheKey(blocks, entry, false, blockIds);
+    size_t gridHash = hashLayoutKey(gridKey);
+    LayoutState layoutState;
+    if (!gridLayouts.lookup(gridHash, gridKey, layoutState)) {
+        layoutState.blocks = &blocks;
+        computeGridLayout(layoutState, entry);
+        layoutState.blocks = nullptr;
+        gridLayouts.insert(gridHash, std::move(gridKey), layoutState, layoutCacheCapacity);
+    }
+    layoutState.blocks = &blocks;
+    computePixelLayout(layoutState, width, height);
+
+    placed.blocks.reserve(blockIds.size());
+    for (ut64 id : blockIds) {
+        placed.blocks.push_back(blocks[id]);
+    }
+    placed.width = width;
+    placed.height = height;
+    placedLayouts.insert(hash, std::move(key), std::move(placed), layoutCacheCapacity);
+}
+
+void GraphGridLayout::computeGridLayout(LayoutState &layoutState, ut64 entry) const
+{
+    auto &blocks = *layoutState.blocks;
     for (auto &it : blocks) {
         GridBlock block;
         block.id = it.first;
@@ -282,7 +435,6 @@ void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, in
         layoutState.edge[blockIt.first].resize(blockIt.second.edges.size());
         for (size_t i = 0; i < blockIt.second.edges.size(); i++) {
             layoutState.edge[blockIt.first][i].dest = blockIt.second.edges[i].target;
-            blockIt.second.edges[i].arrow = GraphEdge::Down;
         }
     }
     for (const auto &edgeList : layoutState.edge) {
@@ -303,6 +455,19 @@ void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, in
         layoutState.columns = std::max(layoutState.columns, size_t(node.second.col) + 2);
     }
 
+    calculateEdgeMainColumn(layoutState);
+    roughRouting(layoutState);
+}
+
+void GraphGridLayout::computePixelLayout(LayoutState &layoutState, int &width, int &height) const
+{
+    auto &blocks = *layoutState.blocks;
+    for (auto &blockIt : blocks) {
+        for (auto &edge : blockIt.second.edges) {
+            edge.arrow = GraphEdge::Down;
+        }
+    }
+
     layoutState.rowHeight.assign(layoutState.rows, 0);
     layoutState.columnWidth.assign(layoutState.columns, 0);
     for (auto &node : layoutState.grid_blocks) {
@@ -315,7 +480,7 @@ void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, in
                                                                 layoutState.columnWidth[node.second.col + 1]);
     }
 
-    routeEdges(layoutState);
+    elaborateEdgePlacement(layoutState);
 
     convertToPixelCoordinates(layoutState, width, height);
     if (useLayoutOptimization) {
@@ -368,124 +533,240 @@ void GraphGridLayout::findMergePoints(GraphGridLayout::LayoutState &state) const
     }
 }
 
-void GraphGridLayout::computeAllBlockPlacement(const std::vector<ut64> &blockOrder,
-                                               LayoutState &layoutState) const
-{
-    assignRows(layoutState, blockOrder);
-    selectTree(layoutState);
-    findMergePoints(layoutState);
+namespace {
+/// Smaller graphs are placed on the calling thread, starting threads would cost more than it saves.
+const size_t PARALLEL_PLACEMENT_MIN_BLOCKS = 2000;
+/// Smallest subtree that is placed by a worker thread.
+const size_t PARALLEL_PLACEMENT_MIN_SUBTREE = 64;
+}
 
+void GraphGridLayout::splitSubtrees(const LayoutState &state, const std::vector<ut64> &blockOrder,
+                                    size_t maxSize, std::vector<std::vector<ut64>> &subtrees,
+                                    std::vector<ut64> &rest)
+{
+    const size_t NO_SUBTREE = SIZE_MAX;
+    std::unordered_map<ut64, size_t> subtreeSize;
+    for (auto blockId : blockOrder) {
+        size_t size = 1;
+        for (auto childId : state.grid_blocks.at(blockId).tree_edge) {
+            size += subtreeSize[childId];
+        }
+        subtreeSize[blockId] = size;
+    }
 
-    // Shapes of subtrees are maintained using linked lists. Each value within list is column relative to previous row.
-    // This allows moving things around by changing only first value in list.
-    LinkedListPool<int> sides(blockOrder.size() * 2); // *2 = two sides for each node
+    // Top to bottom, a block starts a new subtree when it is small enough and its parent wasn't.
+    std::unordered_map<ut64, size_t> owner;
+    for (auto it = blockOrder.rbegin(), end = blockOrder.rend(); it != end; it++) {
+        auto ownerIt = owner.find(*it);
+        size_t subtree;
+        if (ownerIt != owner.end()) {
+            subtree = ownerIt->second;
+        } else {
+            size_t size = subtreeSize[*it];
+            if (size <= maxSize && size >= PARALLEL_PLACEMENT_MIN_SUBTREE) {
+                subtree = subtrees.size();
+                subtrees.emplace_back();
+            } else {
+                subtree = NO_SUBTREE;
+            }
+            owner[*it] = subtree;
+        }
+        if (subtree != NO_SUBTREE) {
+            for (auto childId : state.grid_blocks.at(*it).tree_edge) {
+                owner[childId] = subtree;
+            }
+        }
+    }
 
-    // Process nodes in the order from bottom to top. Ensures that all subtrees are processed before parent node.
     for (auto blockId : blockOrder) {
-        auto &block = layoutState.grid_blocks[blockId];
-        if (block.tree_edge.size() == 0) {
-            block.row_count = 1;
-            block.col = 0;
-            block.lastRowRight = 2;
-            block.lastRowLeft = 0;
-            block.leftPosition = 0;
-            block.rightPosition = 2;
-
-            block.leftSideShape = sides.makeList(0);
-            block.rightSideShape = sides.makeList(2);
+        size_t subtree = owner[blockId];
+        if (subtree == NO_SUBTREE) {
+            rest.push_back(blockId);
         } else {
-            auto &firstChild = layoutState.grid_blocks[block.tree_edge[0]];
-            auto leftSide = firstChild.leftSideShape; // left side of block children subtrees processed so far
-            auto rightSide = firstChild.rightSideShape;
-            block.row_count = firstChild.row_count;
-            block.lastRowRight = firstChild.lastRowRight;
-            block.lastRowLeft = firstChild.lastRowLeft;
-            block.leftPosition = firstChild.leftPosition;
-            block.rightPosition = firstChild.rightPosition;
-            // Place children subtrees side by side
-            for (size_t i = 1; i < block.tree_edge.size(); i++) {
-                auto &child = layoutState.grid_blocks[block.tree_edge[i]];
-                int minPos = INT_MIN;
-                int leftPos = 0;
-                int rightPos = 0;
-                auto leftIt = sides.head(rightSide);
-                auto rightIt = sides.head(child.leftSideShape);
-                int maxLeftWidth = 0;
-                int minRightPos = child.col;
-
-                while (leftIt && rightIt) { // process part of subtrees that touch when put side by side
-                    leftPos += *leftIt;
-                    rightPos += *rightIt;
-                    minPos = std::max(minPos, leftPos - rightPos);
-                    maxLeftWidth = std::max(maxLeftWidth, leftPos);
-                    minRightPos = std::min(minRightPos, rightPos);
-                    ++leftIt;
-                    ++rightIt;
-                }
-                int rightTreeOffset = 0;
-                if (tightSubtreePlacement) {
-                    rightTreeOffset = minPos; // mode a) place subtrees as close as possible
-                } else {
-                    // mode b) use bounding box for shortest subtree and full shape of other side
-                    if (leftIt) {
-                        rightTreeOffset = maxLeftWidth - child.leftPosition;
-                    } else {
-                        rightTreeOffset = block.rightPosition - minRightPos;
-                    }
+            subtrees[subtree].push_back(blockId);
+        }
+    }
+}
 
-                }
-                // Calculate the new shape after putting the two subtrees side by side
-                child.col += rightTreeOffset;
+LinkedListPool<int>::List GraphGridLayout::copyList(LinkedListPool<int> &from,
+                                                    const LinkedListPool<int>::List &list,
+                                                    LinkedListPool<int> &to)
+{
+    LinkedListPool<int>::List result;
+    for (auto it = from.head(list); it; ++it) {
+        result = to.append(result, to.makeList(*it));
+    }
+    return result;
+}
+
+void GraphGridLayout::placeBlock(GridBlock &block, GridBlockMap &blocks,
+                                 LinkedListPool<int> &sides) const
+{
+    // blocks.at() rather than operator[], subtrees are placed concurrently
+    if (block.tree_edge.size() == 0) {
+        block.row_count = 1;
+        block.col = 0;
+        block.lastRowRight = 2;
+        block.lastRowLeft = 0;
+        block.leftPosition = 0;
+        block.rightPosition = 2;
+
+        block.leftSideShape = sides.makeList(0);
+        block.rightSideShape = sides.makeList(2);
+    } else {
+        auto &firstChild = blocks.at(block.tree_edge[0]);
+        auto leftSide = firstChild.leftSideShape; // left side of block children subtrees processed so far
+        auto rightSide = firstChild.rightSideShape;
+        block.row_count = firstChild.row_count;
+        block.lastRowRight = firstChild.lastRowRight;
+        block.lastRowLeft = firstChild.lastRowLeft;
+        block.leftPosition = firstChild.leftPosition;
+        block.rightPosition = firstChild.rightPosition;
+        // Place children subtrees side by side
+        for (size_t i = 1; i < block.tree_edge.size(); i++) {
+            auto &child = blocks.at(block.tree_edge[i]);
+            int minPos = INT_MIN;
+            int leftPos = 0;
+            int rightPos = 0;
+            auto leftIt = sides.head(rightSide);
+            auto rightIt = sides.head(child.leftSideShape);
+            int maxLeftWidth = 0;
+            int minRightPos = child.col;
+
+            while (leftIt && rightIt) { // process part of subtrees that touch when put side by side
+                leftPos += *leftIt;
+                rightPos += *rightIt;
+                minPos = std::max(minPos, leftPos - rightPos);
+                maxLeftWidth = std::max(maxLeftWidth, leftPos);
+                minRightPos = std::min(minRightPos, rightPos);
+                ++leftIt;
+                ++rightIt;
+            }
+            int rightTreeOffset = 0;
+            if (tightSubtreePlacement) {
+                rightTreeOffset = minPos; // mode a) place subtrees as close as possible
+            } else {
+                // mode b) use bounding box for shortest subtree and full shape of other side
                 if (leftIt) {
-                    *leftIt -= (rightTreeOffset + child.lastRowRight - leftPos);
-                    rightSide = sides.append(child.rightSideShape, sides.splitTail(rightSide, leftIt));
-                } else if (rightIt) {
-                    *rightIt += (rightPos + rightTreeOffset - block.lastRowLeft);
-                    leftSide = sides.append(leftSide, sides.splitTail(child.leftSideShape, rightIt));
-
-                    rightSide = child.rightSideShape;
-                    block.lastRowRight = child.lastRowRight + rightTreeOffset;
-                    block.lastRowLeft = child.lastRowLeft + rightTreeOffset;
+                    rightTreeOffset = maxLeftWidth - child.leftPosition;
                 } else {
-                    rightSide = child.rightSideShape;
+                    rightTreeOffset = block.rightPosition - minRightPos;
                 }
-                *sides.head(rightSide) += rightTreeOffset;
-                block.row_count = std::max(block.row_count, child.row_count);
-                block.leftPosition = std::min(block.leftPosition, child.leftPosition + rightTreeOffset);
-                block.rightPosition = std::max(block.rightPosition, rightTreeOffset + child.rightPosition);
-            }
 
-            int col = 0;
-            // Calculate parent position
-            if (parentBetweenDirectChild) {
-                // mode a) keep one child to the left, other to the right
-                for (auto target : block.tree_edge) {
-                    col += layoutState.grid_blocks[target].col;
-                }
-                col /= block.tree_edge.size();
+            }
+            // Calculate the new shape after putting the two subtrees side by side
+            child.col += rightTreeOffset;
+            if (leftIt) {
+                *leftIt -= (rightTreeOffset + child.lastRowRight - leftPos);
+                rightSide = sides.append(child.rightSideShape, sides.splitTail(rightSide, leftIt));
+            } else if (rightIt) {
+                *rightIt += (rightPos + rightTreeOffset - block.lastRowLeft);
+                leftSide = sides.append(leftSide, sides.splitTail(child.leftSideShape, rightIt));
+
+                rightSide = child.rightSideShape;
+                block.lastRowRight = child.lastRowRight + rightTreeOffset;
+                block.lastRowLeft = child.lastRowLeft + rightTreeOffset;
             } else {
-                // mode b) somewhere between left most direct child and right most, preferably in the middle of
-                // horizontal dimensions. Results layout looks more like single vertical line.
-                col = (block.rightPosition + block.leftPosition) / 2 - 1;
-                col = std::max(col, layoutState.grid_blocks[block.tree_edge.front()].col - 1);
-                col = std::min(col, layoutState.grid_blocks[block.tree_edge.back()].col + 1);
+                rightSide = child.rightSideShape;
+            }
+            *sides.head(rightSide) += rightTreeOffset;
+            block.row_count = std::max(block.row_count, child.row_count);
+            block.leftPosition = std::min(block.leftPosition, child.leftPosition + rightTreeOffset);
+            block.rightPosition = std::max(block.rightPosition, rightTreeOffset + child.rightPosition);
+        }
+
+        int col = 0;
+        // Calculate parent position
+        if (parentBetweenDirectChild) {
+            // mode a) keep one child to the left, other to the right
+            for (auto target : block.tree_edge) {
+                col += blocks.at(target).col;
             }
-            block.col += col; // += instead of = to keep offset calculated in previous steps
-            block.row_count += 1;
-            block.leftPosition = std::min(block.leftPosition, block.col);
-            block.rightPosition = std::max(block.rightPosition, block.col + 2);
+            col /= block.tree_edge.size();
+        } else {
+            // mode b) somewhere between left most direct child and right most, preferably in the middle of
+            // horizontal dimensions. Results layout looks more like single vertical line.
+            col = (block.rightPosition + block.leftPosition) / 2 - 1;
+            col = std::max(col, blocks.at(block.tree_edge.front()).col - 1);
+            col = std::min(col, blocks.at(block.tree_edge.back()).col + 1);
+        }
+        block.col += col; // += instead of = to keep offset calculated in previous steps
+        block.row_count += 1;
+        block.leftPosition = std::min(block.leftPosition, block.col);
+        block.rightPosition = std::max(block.rightPosition, block.col + 2);
 
-            *sides.head(leftSide) -= block.col;
-            block.leftSideShape = sides.append(sides.makeList(block.col), leftSide);
+        *sides.head(leftSide) -= block.col;
+        block.leftSideShape = sides.append(sides.makeList(block.col), leftSide);
 
-            *sides.head(rightSide) -= block.col + 2;
-            block.rightSideShape = sides.append(sides.makeList(block.col + 2), rightSide);
+        *sides.head(rightSide) -= block.col + 2;
+        block.rightSideShape = sides.append(sides.makeList(block.col + 2), rightSide);
 
-            // Keep children positions relative to parent so that moving parent moves whole subtree
-            for (auto target : block.tree_edge) {
-                auto &targetBlock = layoutState.grid_blocks[target];
-                targetBlock.col -= block.col;
+        // Keep children positions relative to parent so that moving parent moves whole subtree
+        for (auto target : block.tree_edge) {
+            auto &targetBlock = blocks.at(target);
+            targetBlock.col -= block.col;
+        }
+    }
+}
+
+void GraphGridLayout::computeAllBlockPlacement(const std::vector<ut64> &blockOrder,
+                                               LayoutState &layoutState) const
+{
+    assignRows(layoutState, blockOrder);
+    selectTree(layoutState);
+    findMergePoints(layoutState);
+
+
+    // Shapes of subtrees are maintained using linked lists. Each value within list is column relative to previous row.
+    // This allows moving things around by changing only first value in list.
+    LinkedListPool<int> sides(blockOrder.size() * 2); // *2 = two sides for each node
+
+    // Process nodes in the order from bottom to top. Ensures that all subtrees are processed before parent node.
+    std::vector<std::vector<ut64>> subtrees;
+    std::vector<ut64> rest;
+    size_t threadCount = std::thread::hardware_concurrency();
+    if (blockOrder.size() >= PARALLEL_PLACEMENT_MIN_BLOCKS && threadCount > 1) {
+        size_t maxSubtreeSize = std::max(PARALLEL_PLACEMENT_MIN_SUBTREE,
+                                         blockOrder.size() / (threadCount * 4));
+        splitSubtrees(layoutState, blockOrder, maxSubtreeSize, subtrees, rest);
+    }
+    if (subtrees.size() < 2) {
+        for (auto blockId : blockOrder) {
+            placeBlock(layoutState.grid_blocks[blockId], layoutState.grid_blocks, sides);
+        }
+    } else {
+        // Subtrees don't share any blocks, each of them gets its own list pool. Only the side shapes
+        // of a subtree root are used by its parent, they are copied to the common pool in a fixed order
+        // after all subtrees are done, so the result doesn't depend on the scheduling.
+        std::vector<std::unique_ptr<LinkedListPool<int>>> subtreeSides(subtrees.size());
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            size_t index;
+            while ((index = next++) < subtrees.size()) {
+                subtreeSides[index].reset(new LinkedListPool<int>(subtrees[index].size() * 2));
+                for (auto blockId : subtrees[index]) {
+                    placeBlock(layoutState.grid_blocks.at(blockId), layoutState.grid_blocks,
+                               *subtreeSides[index]);
+                }
             }
+        };
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < std::min(threadCount, subtrees.size()); i++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        for (size_t i = 0; i < subtrees.size(); i++) {
+            // the root comes last in reverse topological order
+            auto &root = layoutState.grid_blocks[subtrees[i].back()];
+            root.leftSideShape = copyList(*subtreeSides[i], root.leftSideShape, sides);
+            root.rightSideShape = copyList(*subtreeSides[i], root.rightSideShape, sides);
+        }
+        for (auto blockId : rest) {
+            placeBlock(layoutState.grid_blocks[blockId], layoutState.grid_blocks, sides);
         }
     }
 
@@ -512,13 +793,6 @@ void GraphGridLayout::computeAllBlockPlacement(const std::vector<ut64> &blockOrd
     }
 }
 
-void GraphGridLayout::routeEdges(GraphGridLayout::LayoutState &state) const
-{
-    calculateEdgeMainColumn(state);
-    roughRouting(state);
-    elaborateEdgePlacement(state);
-}
-
 void GraphGridLayout::calculateEdgeMainColumn(GraphGridLayout::LayoutState &state) const
 {
     // Find an empty column as close as possible to start or end block's column.
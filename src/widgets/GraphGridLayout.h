@@ -27,6 +27,11 @@ public:
     void setParentBetweenDirectChild(bool enabled) { parentBetweenDirectChild = enabled; }
     void setverticalBlockAlignmentMiddle(bool enabled) { verticalBlockAlignmentMiddle = enabled; }
     void setLayoutOptimization(bool enabled) { useLayoutOptimization = enabled; }
+
+    /**
+     * @brief Maximum number of computed layouts kept for reuse, shared by all graph views.
+     */
+    static const size_t layoutCacheCapacity = 32;
 private:
     /// false - use bounding box for smallest subtree when placing them side by side
     bool tightSubtreePlacement = false;
@@ -111,6 +116,27 @@ private:
      */
     void computeAllBlockPlacement(const std::vector<ut64> &blockOrder,
                                   LayoutState &layoutState) const;
+    /**
+     * @brief Place a block relative to its tree children, which have to be placed already.
+     * Only accesses the blocks of the subtree rooted at \a block and their side shapes in \a sides.
+     */
+    void placeBlock(GridBlock &block, GridBlockMap &blocks, LinkedListPool<int> &sides) const;
+    /**
+     * @brief Split the tree into disjoint subtrees that can be placed independently of each other.
+     * @param blockOrder Nodes in the reverse topological order.
+     * @param maxSize Maximum number of nodes in a subtree.
+     * @param subtrees Nodes of each subtree in the order of \a blockOrder, so the root comes last.
+     * @param rest Nodes not in any subtree in the order of \a blockOrder, they are placed after the subtrees.
+     */
+    static void splitSubtrees(const LayoutState &state, const std::vector<ut64> &blockOrder,
+                              size_t maxSize, std::vector<std::vector<ut64>> &subtrees,
+                              std::vector<ut64> &rest);
+    /**
+     * @brief Copy the values of \a list from pool \a from to a new list in pool \a to.
+     */
+    static LinkedListPool<int>::List copyList(LinkedListPool<int> &from,
+                                              const LinkedListPool<int>::List &list,
+                                              LinkedListPool<int> &to);
     /**
      * @brief Perform the topological sorting of graph nodes.
      * If the graph contains loops, a subset of edges is selected. Subset of edges forming DAG are stored in
@@ -133,10 +159,6 @@ private:
      */
     static void selectTree(LayoutState &state);
 
-    /**
-     * @brief routeEdges Route edges, expects node positions to be calculated previously.
-     */
-    void routeEdges(LayoutState &state) const;
     /**
      * @brief Choose which column to use for transition from start node row to target node row.
      */
@@ -188,6 +210,25 @@ private:
      * @param state
      */
     void optimizeLayout(LayoutState &state) const;
+
+    /**
+     * @brief Grid placement of nodes and rough edge routing. Only depends on graph structure
+     * and block widths, not on block heights.
+     */
+    void computeGridLayout(LayoutState &layoutState, ut64 entry) const;
+    /**
+     * @brief Edge placement within grid cells, pixel coordinates and layout optimization
+     * for a state prepared by computeGridLayout().
+     */
+    void computePixelLayout(LayoutState &layoutState, int &width, int &height) const;
+    /**
+     * @brief Describe everything the layout depends on: options, entry and for each block
+     * the id, size and edge targets. Equal keys produce equal layouts.
+     * @param includeHeights false for the key of computeGridLayout() results
+     * @param blockIds output argument, block ids sorted in the order used by the key
+     */
+    std::vector<ut64> layoutCacheKey(const Graph &blocks, ut64 entry, bool includeHeights,
+                                     std::vector<ut64> &blockIds) const;
 };
 
 #endif // GRAPHGRIDLAYOUT_H
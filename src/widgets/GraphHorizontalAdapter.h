@@ -15,6 +15,7 @@ public:
                                  ut64 entry,
                                  int &width,
                                  int &height) const override;
+    bool isThreadSafe() const override { return layout->isThreadSafe(); }
     void setLayoutConfig(const LayoutConfig &config) override;
 private:
     std::unique_ptr<GraphLayout> layout;
@@ -42,6 +42,10 @@ public:
     virtual ~GraphLayout() {}
     virtual void CalculateLayout(Graph &blocks, ut64 entry, int &width,
                                  int &height) const = 0;
+    /**
+     * @brief Whether CalculateLayout may run on a worker thread, concurrently with other layouts.
+     */
+    virtual bool isThreadSafe() const { return true; }
     virtual void setLayoutConfig(const LayoutConfig &config)
     {
         this->layoutConfig = config;
@@ -7,6 +7,8 @@
 #include "GraphHorizontalAdapter.h"
 #include "Helpers.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <QPainter>
 #include <QMouseEvent>
@@ -123,6 +125,7 @@ void GraphView::contextMenuEvent(QContextMenuEvent *event)
 void GraphView::computeGraphPlacement()
 {
     graphLayoutSystem->CalculateLayout(blocks, entry, width, height);
+    invalidateSpatialIndex();
     setCacheDirty();
     clampViewOffset();
     viewport()->update();
@@ -207,15 +210,12 @@ void GraphView::paintEvent(QPaintEvent *)
     }
 #endif
 
-    if (!qFuzzyCompare(getCacheDevicePixelRatioF(), getRequiredCacheDevicePixelRatioF())
-            || getCacheSize() != getRequiredCacheSize()) {
-        setCacheDirty();
-    }
-
     if (cacheDirty) {
-        paintGraphCache();
+        tiles.clear();
         cacheDirty = false;
     }
+    // OpenGL renders the visible area every frame, otherwise the frame is composed from tiles
+    paintGraphCache();
 
     if (useGL) {
 #ifndef CUTTER_NO_OPENGL_GRAPH
@@ -302,21 +302,122 @@ void GraphView::paintGraphCache()
 #endif
     } else {
         auto dpr = qhelpers::devicePixelRatio(this);
-        pixmap = QPixmap(getRequiredCacheSize() * dpr);
-        pixmap.setDevicePixelRatio(dpr);
+        if (!qFuzzyCompare(tileDevicePixelRatio, dpr)) {
+            tiles.clear();
+            tileDevicePixelRatio = dpr;
+        }
+        if (getCacheSize() != getRequiredCacheSize()
+                || !qFuzzyCompare(getCacheDevicePixelRatioF(), dpr)) {
+            pixmap = QPixmap(getRequiredCacheSize());
+            pixmap.setDevicePixelRatio(dpr);
+        }
         pixmap.fill(backgroundColor);
         p.begin(&pixmap);
-        p.setRenderHint(QPainter::Antialiasing);
-        p.setViewport(this->viewport()->rect());
+        paintTiles(p);
+        p.end();
+        return;
     }
     paint(p, offset, this->viewport()->rect(), current_scale);
 
     p.end();
 }
 
+QRectF GraphView::tileRect(const TileKey &key)
+{
+    qreal scale = std::get<0>(key) / 1000000.0;
+    qreal size = tileSize / scale;
+    return QRectF(std::get<1>(key) * size, std::get<2>(key) * size, size, size);
+}
+
+void GraphView::paintTiles(QPainter &p)
+{
+    // a rebuilt index means block positions changed and drops all tiles
+    ensureSpatialIndex();
+
+    tileFrame++;
+    qint64 scaleKey = tileScaleKey(current_scale);
+    // view origin in pixels of the zoomed graph, tiles are aligned to whole pixels
+    QPoint origin(qRound(offset.x() * current_scale), qRound(offset.y() * current_scale));
+    QSize size = viewport()->size();
+    int x0 = static_cast<int>(std::floor(origin.x() / double(tileSize)));
+    int y0 = static_cast<int>(std::floor(origin.y() / double(tileSize)));
+    int x1 = static_cast<int>(std::floor((origin.x() + size.width()) / double(tileSize)));
+    int y1 = static_cast<int>(std::floor((origin.y() + size.height()) / double(tileSize)));
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            const QPixmap &tile = getTile(TileKey(scaleKey, x, y));
+            p.drawPixmap(QPoint(x * tileSize - origin.x(), y * tileSize - origin.y()), tile);
+        }
+    }
+
+    // drop least recently used tiles, those of the current frame are never evicted
+    while (tiles.size() > maxTiles) {
+        auto oldest = tiles.begin();
+        for (auto it = tiles.begin(); it != tiles.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) {
+                oldest = it;
+            }
+        }
+        if (oldest->second.lastUsed == tileFrame) {
+            break;
+        }
+        tiles.erase(oldest);
+    }
+}
+
+const QPixmap &GraphView::getTile(const TileKey &key)
+{
+    auto it = tiles.find(key);
+    if (it == tiles.end()) {
+        QPixmap pixmap(QSize(tileSize, tileSize) * tileDevicePixelRatio);
+        pixmap.setDevicePixelRatio(tileDevicePixelRatio);
+        pixmap.fill(backgroundColor);
+
+        QRectF area = tileRect(key);
+        QPainter p(&pixmap);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.scale(current_scale, current_scale);
+        p.translate(-area.topLeft());
+        p.setBrush(Qt::black);
+        paintArea(p, area, current_scale, true);
+        p.end();
+
+        it = tiles.emplace(key, RenderTile{pixmap, 0}).first;
+    }
+    it->second.lastUsed = tileFrame;
+    return it->second.pixmap;
+}
+
+void GraphView::invalidateTiles(const QRectF &area)
+{
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        if (tileRect(it->first).intersects(area)) {
+            it = tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void GraphView::invalidateBlockTiles(ut64 entry)
+{
+    if (spatialIndexDirty || spatialIndexedBlocks != blocks.size()) {
+        // all tiles are dropped with the index anyway
+        return;
+    }
+    for (const SpatialEntry &spatialEntry : spatialEntries) {
+        bool affected = spatialEntry.block->entry == entry;
+        for (const GraphEdge &edge : spatialEntry.block->edges) {
+            affected = affected || edge.target == entry;
+        }
+        if (affected) {
+            invalidateTiles(spatialEntry.bounds);
+        }
+    }
+}
+
 void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, bool interactive)
 {
-    QPointF offsetF(offset.x(), offset.y());
     p.setBrush(Qt::black);
 
     int render_width = viewport.width();
@@ -326,29 +427,47 @@ void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, b
     QRect window = QRect(offset, QSize(qRound(render_width / scale), qRound(render_height / scale)));
     p.setWindow(window);
     QRectF windowF(window.x(), window.y(), window.width(), window.height());
+    paintArea(p, windowF, scale, interactive);
+}
 
-    for (auto &blockIt : blocks) {
-        GraphBlock &block = blockIt.second;
+void GraphView::paintArea(QPainter &p, const QRectF &windowF, qreal scale, bool interactive)
+{
+    // far zoomed out views use simplified blocks and edges, exports always get full detail
+    bool overview = interactive && scale < overviewScale;
+
+    std::vector<uint32_t> visibleBlocks;
+    querySpatialIndex(windowF, visibleBlocks);
+    for (uint32_t index : visibleBlocks) {
+        GraphBlock &block = *spatialEntries[index].block;
 
         QRectF blockRect(block.x, block.y, block.width, block.height);
 
         // Check if block is visible by checking if block intersects with view area
         if (blockRect.intersects(windowF)) {
-            drawBlock(p, block, interactive);
+            if (overview) {
+                drawBlockOverview(p, block);
+            } else {
+                drawBlock(p, block, interactive);
+            }
         }
 
         p.setBrush(Qt::gray);
 
-        // Always draw edges
-        // TODO: Only draw edges if they are actually visible ...
         // Draw edges
         for (GraphEdge &edge : block.edges) {
-            if (edge.polyline.empty()) {
+            if (edge.polyline.empty()
+                    || !edge.polyline.boundingRect().adjusted(-8, -8, 8, 8).intersects(windowF)) {
                 continue;
             }
             QPolygonF polyline = edge.polyline;
             EdgeConfiguration ec = edgeConfiguration(block, &blocks[edge.target], interactive);
             QPen pen(ec.color);
+            if (overview) {
+                pen.setWidth(0);
+                p.setPen(pen);
+                p.drawPolyline(polyline);
+                continue;
+            }
             pen.setStyle(ec.lineStyle);
             pen.setWidthF(pen.width() * ec.width_scale);
             if (scale_thickness_multiplier && ec.width_scale > 1.01 && pen.widthF() * scale < 2) {
@@ -500,8 +619,10 @@ void GraphView::showRectangle(const QRect &block, bool anywhere)
 GraphView::GraphBlock *GraphView::getBlockContaining(QPoint p)
 {
     // Check if a block was clicked
-    for (auto &blockIt : blocks) {
-        GraphBlock &block = blockIt.second;
+    std::vector<uint32_t> candidates;
+    querySpatialIndex(QRectF(p, QSizeF(1, 1)), candidates);
+    for (uint32_t index : candidates) {
+        GraphBlock &block = *spatialEntries[index].block;
 
         QRect rec(block.x, block.y, block.width, block.height);
         if (rec.contains(p)) {
@@ -603,6 +724,97 @@ std::unique_ptr<GraphLayout> GraphView::makeGraphLayout(GraphView::Layout layout
 void GraphView::addBlock(GraphView::GraphBlock block)
 {
     blocks[block.entry] = block;
+    invalidateSpatialIndex();
+}
+
+void GraphView::drawBlockOverview(QPainter &p, GraphView::GraphBlock &block)
+{
+    p.setPen(QPen(Qt::black, 0));
+    p.setBrush(Qt::gray);
+    p.drawRect(QRectF(block.x, block.y, block.width, block.height));
+}
+
+void GraphView::rebuildSpatialIndex()
+{
+    spatialEntries.clear();
+    spatialCells.clear();
+    spatialEntries.reserve(blocks.size());
+    for (auto &blockIt : blocks) {
+        GraphBlock &block = blockIt.second;
+        QRectF bounds(block.x, block.y, block.width, block.height);
+        for (const GraphEdge &edge : block.edges) {
+            if (!edge.polyline.empty()) {
+                // leave room for arrow heads and straight lines with an empty bounding rect
+                bounds |= edge.polyline.boundingRect().adjusted(-8, -8, 8, 8);
+            }
+        }
+        uint32_t index = static_cast<uint32_t>(spatialEntries.size());
+        spatialEntries.push_back({&block, bounds});
+
+        int x0 = static_cast<int>(std::floor(bounds.left() / spatialCellSize));
+        int x1 = static_cast<int>(std::floor(bounds.right() / spatialCellSize));
+        int y0 = static_cast<int>(std::floor(bounds.top() / spatialCellSize));
+        int y1 = static_cast<int>(std::floor(bounds.bottom() / spatialCellSize));
+        for (int x = x0; x <= x1; x++) {
+            for (int y = y0; y <= y1; y++) {
+                quint64 key = (quint64(quint32(x)) << 32) | quint32(y);
+                spatialCells[key].push_back(index);
+            }
+        }
+    }
+    spatialVisited.assign(spatialEntries.size(), 0);
+    spatialQueryId = 0;
+    spatialIndexedBlocks = blocks.size();
+    spatialIndexDirty = false;
+}
+
+void GraphView::ensureSpatialIndex()
+{
+    if (spatialIndexDirty || spatialIndexedBlocks != blocks.size()) {
+        rebuildSpatialIndex();
+        tiles.clear();
+    }
+}
+
+void GraphView::querySpatialIndex(const QRectF &rect, std::vector<uint32_t> &result)
+{
+    ensureSpatialIndex();
+    result.clear();
+    if (++spatialQueryId == 0) {
+        std::fill(spatialVisited.begin(), spatialVisited.end(), 0);
+        spatialQueryId = 1;
+    }
+
+    int x0 = static_cast<int>(std::floor(rect.left() / spatialCellSize));
+    int x1 = static_cast<int>(std::floor(rect.right() / spatialCellSize));
+    int y0 = static_cast<int>(std::floor(rect.top() / spatialCellSize));
+    int y1 = static_cast<int>(std::floor(rect.bottom() / spatialCellSize));
+    if (qint64(x1 - x0 + 1) * (y1 - y0 + 1) > qint64(spatialCells.size())) {
+        // zoomed out far enough that walking all cells is cheaper
+        for (uint32_t i = 0; i < spatialEntries.size(); i++) {
+            if (spatialEntries[i].bounds.intersects(rect)) {
+                result.push_back(i);
+            }
+        }
+        return;
+    }
+    for (int x = x0; x <= x1; x++) {
+        for (int y = y0; y <= y1; y++) {
+            auto cell = spatialCells.find((quint64(quint32(x)) << 32) | quint32(y));
+            if (cell == spatialCells.end()) {
+                continue;
+            }
+            for (uint32_t index : cell->second) {
+                if (spatialVisited[index] != spatialQueryId
+                        && spatialEntries[index].bounds.intersects(rect)) {
+                    spatialVisited[index] = spatialQueryId;
+                    result.push_back(index);
+                }
+            }
+        }
+    }
+    // keep the same drawing order independent of the view position
+    std::sort(result.begin(), result.end());
 }
 
 void GraphView::setEntry(ut64 e)
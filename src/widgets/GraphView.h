@@ -13,6 +13,8 @@
 #include <unordered_set>
 #include <queue>
 #include <memory>
+#include <map>
+#include <tuple>
 
 #include "core/Cutter.h"
 #include "widgets/GraphLayout.h"
@@ -113,11 +115,39 @@ protected:
     // Padding inside the block
     int block_padding = 16;
 
+    /**
+     * @brief Throw away every rendered tile, use invalidateTiles() if only part of the graph changed.
+     */
     void setCacheDirty()    { cacheDirty = true; }
+    /**
+     * @brief Rerender the tiles overlapping area (in graph coordinates) in the next frame.
+     */
+    void invalidateTiles(const QRectF &area);
+    /**
+     * @brief Rerender a block, its outgoing edges and the edges leading to it.
+     */
+    void invalidateBlockTiles(ut64 entry);
+
+    /**
+     * @brief Layout system that stays alive even if the layout is changed meanwhile,
+     * for computing a placement outside of the GUI thread.
+     */
+    std::shared_ptr<const GraphLayout> sharedGraphLayout() const { return graphLayoutSystem; }
 
     void addBlock(GraphView::GraphBlock block);
     void setEntry(ut64 e);
 
+    /**
+     * @brief Must be called when block positions change without computeGraphPlacement() or addBlock().
+     */
+    void invalidateSpatialIndex()   { spatialIndexDirty = true; }
+
+    /**
+     * @brief Below this zoom level blocks are drawn with drawBlockOverview() and edges
+     * without arrows, text wouldn't be readable anyway.
+     */
+    qreal overviewScale = 0.3;
+
     // Callbacks that should be overridden
     /**
      * @brief drawBlock
@@ -126,6 +156,12 @@ protected:
      * @param interactive - can be used for disabling elemnts during export
      */
     virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive = true) = 0;
+    /**
+     * @brief Cheap replacement for drawBlock() used when zoomed out below overviewScale.
+     * @param p painter object
+     * @param block
+     */
+    virtual void drawBlockOverview(QPainter &p, GraphView::GraphBlock &block);
     virtual void blockClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos);
     virtual void blockDoubleClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos);
     virtual void blockHelpEvent(GraphView::GraphBlock &block, QHelpEvent *event, QPoint pos);
@@ -171,6 +207,10 @@ private:
     void centerY(bool emitSignal);
 
     void paintGraphCache();
+    /**
+     * @brief Paint the blocks and edges within area, painter transformation is already set up.
+     */
+    void paintArea(QPainter &p, const QRectF &area, qreal scale, bool interactive);
 
     bool checkPointClicked(QPointF &point, int x, int y, bool above_y = false);
 
@@ -181,7 +221,7 @@ private:
 
     ut64 entry = 0;
 
-    std::unique_ptr<GraphLayout> graphLayoutSystem;
+    std::shared_ptr<GraphLayout> graphLayoutSystem;
 
     // Scrolling data
     int scroll_base_x = 0;
@@ -203,7 +243,28 @@ private:
 #endif
 
     /**
-     * @brief flag to control if the cache is invalid and should be re-created in the next draw
+     * @brief Graph rendered in pieces of tileSize x tileSize pixels at a given zoom level. When
+     * rendering without OpenGL, frames are composed from these tiles so panning and returning to
+     * a previous zoom level only renders the tiles that weren't visible before.
+     */
+    struct RenderTile {
+        QPixmap pixmap;
+        quint64 lastUsed;
+    };
+    using TileKey = std::tuple<qint64, int, int>; //!< zoom level, column, row
+    static const int tileSize = 256;
+    static const size_t maxTiles = 128;
+    std::map<TileKey, RenderTile> tiles;
+    quint64 tileFrame = 0;
+    qreal tileDevicePixelRatio = 0;
+
+    static qint64 tileScaleKey(qreal scale)     { return qRound64(scale * 1000000); }
+    static QRectF tileRect(const TileKey &key);
+    void paintTiles(QPainter &p);
+    const QPixmap &getTile(const TileKey &key);
+
+    /**
+     * @brief flag to control if the cached tiles are invalid and should be re-created in the next draw
      */
     bool cacheDirty = true;
     QSize getCacheSize();
@@ -212,6 +273,29 @@ private:
     qreal getRequiredCacheDevicePixelRatioF();
 
     void beginMouseDrag(QMouseEvent *event);
+
+    /**
+     * @brief Uniform grid over the graph, each cell lists the blocks whose rectangle or
+     * outgoing edges overlap it.
+     */
+    struct SpatialEntry {
+        GraphBlock *block;
+        QRectF bounds; //!< block and its outgoing edges
+    };
+    static const int spatialCellSize = 512;
+    std::vector<SpatialEntry> spatialEntries;
+    std::unordered_map<quint64, std::vector<uint32_t>> spatialCells;
+    std::vector<uint32_t> spatialVisited;
+    uint32_t spatialQueryId = 0;
+    bool spatialIndexDirty = true;
+    size_t spatialIndexedBlocks = 0;
+
+    void rebuildSpatialIndex();
+    void ensureSpatialIndex();
+    /**
+     * @brief Indices into spatialEntries of blocks that may overlap rect, in drawing order.
+     */
+    void querySpatialIndex(const QRectF &rect, std::vector<uint32_t> &result);
 public:
     QPoint getViewOffset() const    { return offset; }
     void setViewOffset(QPoint offset);
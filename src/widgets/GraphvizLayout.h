@@ -24,6 +24,8 @@ public:
                                  ut64 entry,
                                  int &width,
                                  int &height) const override;
+    // graphviz keeps global state and is not reentrant
+    bool isThreadSafe() const override { return false; }
 private:
     Direction direction;
     LayoutType layoutType;
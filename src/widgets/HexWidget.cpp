@@ -705,7 +705,7 @@ void HexWidget::w_writeString()
         Core()->cmdRawAt(QString("w %1")
                             .arg(str),
                             getLocationAddress());
-        refresh();
+        refreshWritten(str.toUtf8().size());
     }
 }
 
@@ -725,7 +725,7 @@ void HexWidget::w_increaseDecrease()
                         .arg(mode)
                         .arg(QString::number(d.getValue())),
                         getLocationAddress());
-    refresh();
+    refreshWritten(d.getNBytes());
 }
 
 void HexWidget::w_writeZeros()
@@ -747,7 +747,7 @@ void HexWidget::w_writeZeros()
         Core()->cmdRawAt(QString("w0 %1")
                             .arg(str),
                             getLocationAddress());
-        refresh();
+        refreshWritten(str.toULongLong());
     }
 }
 
@@ -776,7 +776,7 @@ void HexWidget::w_write64()
                         .arg(mode)
                         .arg((mode == "e" ? str.toHex() : str).toStdString().c_str()),
                         getLocationAddress());
-    refresh();
+    refreshWritten(mode == "e" ? str.toBase64().size() : QByteArray::fromBase64(str).size());
 }
 
 void HexWidget::w_writeRandom()
@@ -797,7 +797,7 @@ void HexWidget::w_writeRandom()
         Core()->cmdRawAt(QString("wr %1")
                             .arg(nbytes),
                             getLocationAddress());
-        refresh();
+        refreshWritten(nbytes.toULongLong());
     }
 }
 
@@ -817,7 +817,7 @@ void HexWidget::w_duplFromOffset()
                             .arg(copyFrom)
                             .arg(nBytes),
                             getLocationAddress());
-    refresh();
+    refreshWritten(d.getNBytes());
 }
 
 void HexWidget::w_writePascalString()
@@ -834,7 +834,7 @@ void HexWidget::w_writePascalString()
         Core()->cmdRawAt(QString("ws %1")
                             .arg(str),
                             getLocationAddress());
-        refresh();
+        refreshWritten(str.toUtf8().size() + 1);
     }
 }
 
@@ -852,7 +852,7 @@ void HexWidget::w_writeWideString()
         Core()->cmdRawAt(QString("ww %1")
                             .arg(str),
                             getLocationAddress());
-        refresh();
+        refreshWritten(str.toUtf8().size() * 2);
     }
 }
 
@@ -870,7 +870,7 @@ void HexWidget::w_writeCString()
         Core()->cmdRawAt(QString("wz %1")
                             .arg(str),
                             getLocationAddress());
-        refresh();
+        refreshWritten(str.toUtf8().size() + 1);
     }
 }
 
@@ -1498,6 +1498,118 @@ void HexWidget::fetchData()
     data->fetch(startAddress, bytesPerScreen());
 }
 
+void HexWidget::refreshWritten(uint64_t size)
+{
+    // HexdumpWidget refreshes this view on instructionChanged, together with the code views
+    MemoryBlockCache::instance().notifyWritten(getLocationAddress(), size);
+}
+
+MemoryBlockCache &MemoryBlockCache::instance()
+{
+    static MemoryBlockCache *cache = nullptr;
+    if (!cache) {
+        cache = new MemoryBlockCache();
+        // anything else changing the memory is reported through these
+        auto clearCache = []() {
+            cache->clear();
+        };
+        QObject::connect(Core(), &CutterCore::refreshAll, Core(), clearCache);
+        QObject::connect(Core(), &CutterCore::refreshCodeViews, Core(), clearCache);
+        QObject::connect(Core(), &CutterCore::instructionChanged, Core(), []() {
+            if (!cache->m_notifyingWrite) {
+                cache->clear();
+            }
+        });
+        QObject::connect(Core(), &CutterCore::stackChanged, Core(), clearCache);
+        QObject::connect(Core(), &CutterCore::registersChanged, Core(), clearCache);
+    }
+    return *cache;
+}
+
+void MemoryBlockCache::read(uint64_t addr, int count, QVector<QByteArray> &out)
+{
+    out.clear();
+    out.reserve(count);
+    for (int i = 0; i < count; i++) {
+        out.append(block(addr + i * BLOCK_SIZE));
+    }
+
+    // prefetch the blocks the next scroll in the same direction will need
+    const uint64_t readAheadSize = READ_AHEAD_BLOCKS * BLOCK_SIZE;
+    const uint64_t end = addr + static_cast<uint64_t>(count) * BLOCK_SIZE;
+    if (addr > m_lastReadAddr && end > addr) {
+        for (uint64_t a = end; a - end < readAheadSize && a >= end; a += BLOCK_SIZE) {
+            block(a);
+        }
+    } else if (addr < m_lastReadAddr) {
+        uint64_t start = addr > readAheadSize ? addr - readAheadSize : 0;
+        for (uint64_t a = start; a < addr; a += BLOCK_SIZE) {
+            block(a);
+        }
+    }
+    m_lastReadAddr = addr;
+}
+
+const QByteArray &MemoryBlockCache::block(uint64_t addr)
+{
+    auto it = m_blocks.find(addr);
+    if (it != m_blocks.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruIt);
+        return it->second.data;
+    }
+
+    while (m_blocks.size() >= MAX_BLOCKS) {
+        m_blocks.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+    m_lru.push_front(addr);
+    Block &b = m_blocks[addr];
+    b.data = Core()->ioRead(addr, BLOCK_SIZE);
+    b.lruIt = m_lru.begin();
+    return b.data;
+}
+
+void MemoryBlockCache::notifyWritten(uint64_t addr, uint64_t size)
+{
+    invalidate(addr, size);
+    m_notifyingWrite = true;
+    emit Core()->instructionChanged(addr);
+    m_notifyingWrite = false;
+}
+
+void MemoryBlockCache::invalidate(uint64_t addr, uint64_t size)
+{
+    if (!size) {
+        return;
+    }
+    uint64_t first = addr & ~(BLOCK_SIZE - 1);
+    uint64_t last = addr + size - 1 < addr ? UINT64_MAX : addr + size - 1;
+    if ((last - first) / BLOCK_SIZE >= m_blocks.size()) {
+        for (auto it = m_blocks.begin(); it != m_blocks.end();) {
+            if (it->first + BLOCK_SIZE - 1 >= first && it->first <= last) {
+                m_lru.erase(it->second.lruIt);
+                it = m_blocks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return;
+    }
+    for (uint64_t a = first; a <= last && a >= first; a += BLOCK_SIZE) {
+        auto it = m_blocks.find(a);
+        if (it != m_blocks.end()) {
+            m_lru.erase(it->second.lruIt);
+            m_blocks.erase(it);
+        }
+    }
+}
+
+void MemoryBlockCache::clear()
+{
+    m_blocks.clear();
+    m_lru.clear();
+}
+
 BasicCursor HexWidget::screenPosToAddr(const QPoint &point,  bool middle) const
 {
     QPointF pt = point - itemArea.topLeft();
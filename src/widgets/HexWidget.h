@@ -9,6 +9,8 @@
 #include <QTimer>
 #include <QMenu>
 #include <memory>
+#include <list>
+#include <unordered_map>
 
 struct BasicCursor
 {
@@ -118,17 +120,60 @@ private:
     QByteArray m_buffer;
 };
 
+/**
+ * @brief LRU cache of memory blocks shared by all MemoryData instances.
+ *
+ * Blocks are dropped when the memory may have been modified: by the write actions of HexWidget
+ * and whenever the core reports changed code, registers or stack.
+ */
+class MemoryBlockCache
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t MAX_BLOCKS = 1024;
+    static constexpr int READ_AHEAD_BLOCKS = 16;
+
+    static MemoryBlockCache &instance();
+
+    /**
+     * @brief Get count blocks starting at the block aligned addr and read ahead in the
+     * direction of the previous read.
+     */
+    void read(uint64_t addr, int count, QVector<QByteArray> &out);
+    void invalidate(uint64_t addr, uint64_t size);
+    void clear();
+    /**
+     * @brief Drop the blocks of a write and tell the other views about it through
+     * CutterCore::instructionChanged, without clearing the rest of the cache.
+     */
+    void notifyWritten(uint64_t addr, uint64_t size);
+
+private:
+    MemoryBlockCache() {}
+
+    struct Block {
+        QByteArray data;
+        std::list<uint64_t>::iterator lruIt;
+    };
+
+    const QByteArray &block(uint64_t addr);
+
+    std::unordered_map<uint64_t, Block> m_blocks;
+    std::list<uint64_t> m_lru; //!< most recently used first
+    uint64_t m_lastReadAddr = 0;
+    bool m_notifyingWrite = false;
+};
+
 class MemoryData : public AbstractData
 {
 public:
     MemoryData() {}
     ~MemoryData() override {}
-    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t BLOCK_SIZE = MemoryBlockCache::BLOCK_SIZE;
 
     void fetch(uint64_t address, int length) override
     {
-        // FIXME: reuse data if possible
-        const uint64_t blockSize = 0x1000ULL;
+        const uint64_t blockSize = BLOCK_SIZE;
         uint64_t alignedAddr = address & ~(blockSize - 1);
         int offset = address - alignedAddr;
         int len = (offset + length + (blockSize - 1)) & ~(blockSize - 1);
@@ -138,11 +183,7 @@ public:
             m_lastValidAddr = -1;
             len = m_lastValidAddr - m_firstBlockAddr + 1;
         }
-        m_blocks.clear();
-        uint64_t addr = alignedAddr;
-        for (ut64 i = 0; i < len / blockSize; ++i, addr += blockSize) {
-            m_blocks.append(Core()->ioRead(addr, blockSize));
-        }
+        MemoryBlockCache::instance().read(alignedAddr, len / blockSize, m_blocks);
     }
 
     bool copy(void *out, uint64_t addr, size_t len) override {
@@ -352,6 +393,10 @@ private:
     RVA getLocationAddress();
 
     void fetchData();
+    /**
+     * @brief Drop cached memory written at the current location and refresh the view.
+     */
+    void refreshWritten(uint64_t size);
     /**
      * @brief Convert mouse position to address.
      * @param point mouse position in widget
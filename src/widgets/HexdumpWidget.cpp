@@ -204,8 +204,47 @@ void HexdumpWidget::fontsUpdated()
     setupFonts();
 }
 
+void HexdumpWidget::startHashTask(RVA start_address, int size)
+{
+    if (hashTask) {
+        // results of the previous selection are ignored once it finishes
+        hashTask->interrupt();
+    }
+    ui->bytesMD5->setText("");
+    ui->bytesSHA1->setText("");
+    ui->bytesSHA256->setText("");
+    ui->bytesCRC32->setText("");
+    ui->bytesEntropy->setText("");
+
+    hashTask.reset(new HashTask(start_address, static_cast<ut64>(size)));
+    HashTask *task = hashTask.data();
+    connect(task, &AsyncTask::finished, this, [this, task]() {
+        if (task != hashTask.data()) {
+            return;
+        }
+        hashTask.clear();
+        if (task->isInterrupted()) {
+            return;
+        }
+        ui->bytesMD5->setText(task->getMd5());
+        ui->bytesSHA1->setText(task->getSha1());
+        ui->bytesSHA256->setText(task->getSha256());
+        ui->bytesCRC32->setText(task->getCrc32());
+        ui->bytesEntropy->setText(task->getEntropy());
+        ui->bytesMD5->setCursorPosition(0);
+        ui->bytesSHA1->setCursorPosition(0);
+        ui->bytesSHA256->setCursorPosition(0);
+        ui->bytesCRC32->setCursorPosition(0);
+    });
+    Core()->getAsyncTaskManager()->start(hashTask);
+}
+
 void HexdumpWidget::clearParseWindow()
 {
+    if (hashTask) {
+        hashTask->interrupt();
+        hashTask.clear();
+    }
     ui->hexDisasTextEdit->setPlainText("");
     ui->bytesEntropy->setText("");
     ui->bytesMD5->setText("");
@@ -256,15 +295,7 @@ void HexdumpWidget::updateParseWindow(RVA start_address, int size)
                                                                     , start_address) : "");
     } else {
         // Fill the information tab hashes and entropy
-        ui->bytesMD5->setText(Core()->cmdRawAt(QString("ph md5 %1").arg(size), start_address).trimmed());
-        ui->bytesSHA1->setText(Core()->cmdRawAt(QString("ph sha1 %1").arg(size), start_address).trimmed());
-        ui->bytesSHA256->setText(Core()->cmdRawAt(QString("ph sha256 %1").arg(size), start_address).trimmed());
-        ui->bytesCRC32->setText(Core()->cmdRawAt(QString("ph crc32 %1").arg(size), start_address).trimmed());
-        ui->bytesEntropy->setText(Core()->cmdRawAt(QString("ph entropy %1").arg(size), start_address).trimmed());
-        ui->bytesMD5->setCursorPosition(0);
-        ui->bytesSHA1->setCursorPosition(0);
-        ui->bytesSHA256->setCursorPosition(0);
-        ui->bytesCRC32->setCursorPosition(0);
+        startHashTask(start_address, size);
     }
 }
 
@@ -14,6 +14,7 @@
 #include "common/CutterSeekable.h"
 #include "common/Highlighter.h"
 #include "common/SvgIconEngine.h"
+#include "common/HashTask.h"
 #include "HexWidget.h"
 
 #include "Dashboard.h"
@@ -48,6 +49,7 @@ private:
 
     RefreshDeferrer *refreshDeferrer;
     QSyntaxHighlighter *syntaxHighLighter;
+    QSharedPointer<HashTask> hashTask;
 
     void refresh();
     void refresh(RVA addr);
@@ -58,6 +60,7 @@ private:
     void refreshSelectionInfo();
     void updateParseWindow(RVA start_address, int size);
     void clearParseWindow();
+    void startHashTask(RVA start_address, int size);
     void showSidePanel(bool show);
 
     QString getWindowTitle() const override;
@@ -10,6 +10,8 @@
 OverviewView::OverviewView(QWidget *parent)
     : GraphView(parent)
 {
+    // drawBlock already is a simplified rendering
+    overviewScale = 0;
     connect(Config(), &Configuration::colorsUpdated, this, &OverviewView::colorsUpdatedSlot);
     colorsUpdatedSlot();
 }
@@ -21,6 +23,7 @@ void OverviewView::setData(int baseWidth, int baseHeight,
     width = baseWidth;
     height = baseHeight;
     blocks = baseBlocks;
+    invalidateSpatialIndex();
     edgeConfigurations = baseEdgeConfigurations;
     scaleAndCenter();
     setCacheDirty();
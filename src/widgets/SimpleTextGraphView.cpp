@@ -57,6 +57,7 @@ void SimpleTextGraphView::refreshView()
 {
     initFont();
     setLayoutConfig(getLayoutConfig());
+    setCacheDirty();
     saveCurrentBlock();
     loadCurrentGraph();
     if (blocks.find(selectedBlock) == blocks.end()) {
@@ -251,7 +252,11 @@ void SimpleTextGraphView::restoreCurrentBlock()
 
 void SimpleTextGraphView::paintEvent(QPaintEvent *event)
 {
-    // SimpleTextGraphView is always dirty
-    setCacheDirty();
+    // only rerender the blocks whose selection changed since the last frame
+    if (selectedBlock != paintedSelectedBlock) {
+        invalidateBlockTiles(paintedSelectedBlock);
+        invalidateBlockTiles(selectedBlock);
+        paintedSelectedBlock = selectedBlock;
+    }
     GraphView::paintEvent(event);
 }
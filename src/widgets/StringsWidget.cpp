@@ -9,15 +9,35 @@
 #include <QModelIndex>
 #include <QShortcut>
 
-StringsModel::StringsModel(QList<StringDescription> *strings, QObject *parent)
-    : AddressableItemModel<QAbstractListModel>(parent),
-      strings(strings)
+StringsModel::StringsModel(QObject *parent)
+    : AddressableItemModel<QAbstractListModel>(parent)
 {
+    texts.setMaxCost(TEXT_CACHE_SIZE);
+}
+
+void StringsModel::reset(QSharedPointer<const StringsSource> source)
+{
+    beginResetModel();
+    this->source = std::move(source);
+    strings.clear();
+    strings.squeeze();
+    texts.clear();
+    endResetModel();
+}
+
+void StringsModel::appendStrings(const QVector<ScannedString> &newStrings)
+{
+    if (newStrings.isEmpty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), strings.size(), strings.size() + newStrings.size() - 1);
+    strings += newStrings;
+    endInsertRows();
 }
 
 int StringsModel::rowCount(const QModelIndex &) const
 {
-    return strings->count();
+    return strings.count();
 }
 
 int StringsModel::columnCount(const QModelIndex &) const
@@ -27,31 +47,31 @@ int StringsModel::columnCount(const QModelIndex &) const
 
 QVariant StringsModel::data(const QModelIndex &index, int role) const
 {
-    if (index.row() >= strings->count())
+    if (index.row() >= strings.count())
         return QVariant();
 
-    const StringDescription &str = strings->at(index.row());
+    const ScannedString &str = strings.at(index.row());
 
     switch (role) {
     case Qt::DisplayRole:
         switch (index.column()) {
         case StringsModel::OffsetColumn:
-            return RAddressString(str.vaddr);
+            return RAddressString(source->vaddr(str));
         case StringsModel::StringColumn:
-            return str.string;
+            return text(index.row());
         case StringsModel::TypeColumn:
-            return str.type.toUpper();
+            return source->type(str).toUpper();
         case StringsModel::LengthColumn:
             return QString::number(str.length);
         case StringsModel::SizeColumn:
             return QString::number(str.size);
         case StringsModel::SectionColumn:
-            return str.section;
+            return source->section(str);
         default:
             return QVariant();
         }
     case StringDescriptionRole:
-        return QVariant::fromValue(str);
+        return QVariant::fromValue(source->description(str));
     default:
         return QVariant();
     }
@@ -84,13 +104,22 @@ QVariant StringsModel::headerData(int section, Qt::Orientation, int role) const
 
 RVA StringsModel::address(const QModelIndex &index) const
 {
-    const StringDescription &str = strings->at(index.row());
-    return str.vaddr;
+    return source->vaddr(strings.at(index.row()));
 }
 
-const StringDescription *StringsModel::description(const QModelIndex &index) const
+const ScannedString &StringsModel::string(const QModelIndex &index) const
 {
-    return &strings->at(index.row());
+    return strings.at(index.row());
+}
+
+QString StringsModel::text(int row) const
+{
+    if (const QString *cached = texts.object(row)) {
+        return *cached;
+    }
+    QString text = source->text(strings.at(row));
+    texts.insert(row, new QString(text));
+    return text;
 }
 
 StringsProxyModel::StringsProxyModel(StringsModel *sourceModel, QObject *parent)
@@ -102,39 +131,43 @@ StringsProxyModel::StringsProxyModel(StringsModel *sourceModel, QObject *parent)
 
 bool StringsProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
-    QModelIndex index = sourceModel()->index(row, 0, parent);
-    StringDescription str = index.data(StringsModel::StringDescriptionRole).value<StringDescription>();
+    auto model = static_cast<StringsModel *>(sourceModel());
+    const StringsSource *source = model->getSource();
+    const ScannedString &str = model->string(model->index(row, 0, parent));
+    if (selectedSection.isEmpty() && filterRegExp().isEmpty())
+        return true;
     if (selectedSection.isEmpty())
-        return str.string.contains(filterRegExp());
+        return model->text(row).contains(filterRegExp());
     else
-        return selectedSection == str.section && str.string.contains(filterRegExp());
+        return selectedSection == source->section(str) && model->text(row).contains(filterRegExp());
 }
 
 bool StringsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
     auto model = static_cast<StringsModel *>(sourceModel());
-    auto leftStr = model->description(left);
-    auto rightStr = model->description(right);
+    const StringsSource *source = model->getSource();
+    const ScannedString &leftStr = model->string(left);
+    const ScannedString &rightStr = model->string(right);
 
     switch (left.column()) {
     case StringsModel::OffsetColumn:
-        return leftStr->vaddr < rightStr->vaddr;
+        return source->vaddr(leftStr) < source->vaddr(rightStr);
     case StringsModel::StringColumn: // sort by string
-        return leftStr->string < rightStr->string;
+        return model->text(left.row()) < model->text(right.row());
     case StringsModel::TypeColumn: // sort by type
-        return leftStr->type < rightStr->type;
+        return source->type(leftStr) < source->type(rightStr);
     case StringsModel::SizeColumn: // sort by size
-        return leftStr->size < rightStr->size;
+        return leftStr.size < rightStr.size;
     case StringsModel::LengthColumn: // sort by length
-        return leftStr->length < rightStr->length;
+        return leftStr.length < rightStr.length;
     case StringsModel::SectionColumn:
-        return leftStr->section < rightStr->section;
+        return source->section(leftStr) < source->section(rightStr);
     default:
         break;
     }
 
     // fallback
-    return leftStr->vaddr < rightStr->vaddr;
+    return source->vaddr(leftStr) < source->vaddr(rightStr);
 }
 
 StringsWidget::StringsWidget(MainWindow *main) :
@@ -162,7 +195,7 @@ StringsWidget::StringsWidget(MainWindow *main) :
 
     ui->stringsTreeView->setContextMenuPolicy(Qt::CustomContextMenu);
 
-    model = new StringsModel(&strings, this);
+    model = new StringsModel(this);
     proxyModel = new StringsProxyModel(model, this);
     ui->stringsTreeView->setMainWindow(main);
     ui->stringsTreeView->setModel(proxyModel);
@@ -215,15 +248,35 @@ StringsWidget::~StringsWidget() {}
 void StringsWidget::refreshStrings()
 {
     if (task) {
+        task->interrupt();
         task->wait();
+        task.clear();
     }
 
-    task = QSharedPointer<StringsTask>(new StringsTask());
-    connect(task.data(), &StringsTask::stringSearchFinished, this,
-            &StringsWidget::stringSearchFinished);
-    Core()->getAsyncTaskManager()->start(task);
-
+    auto source = StringsSource::fromCurrentFile();
+    model->reset(source);
+    tree->showItemsNumber(proxyModel->rowCount());
     refreshSectionCombo();
+
+    if (!source) {
+        return;
+    }
+
+    // results are shown batch by batch while the search is running
+    task = QSharedPointer<StringsTask>(new StringsTask(source));
+    StringsTask *stringsTask = task.data();
+    connect(stringsTask, &StringsTask::stringsFound, this,
+            [this, stringsTask](const QVector<ScannedString> &strings) {
+        if (stringsTask == task.data()) {
+            stringsFound(strings);
+        }
+    });
+    connect(stringsTask, &AsyncTask::finished, this, [this, stringsTask]() {
+        if (stringsTask == task.data()) {
+            task.clear();
+        }
+    });
+    Core()->getAsyncTaskManager()->start(task);
 }
 
 void StringsWidget::refreshSectionCombo()
@@ -240,15 +293,10 @@ void StringsWidget::refreshSectionCombo()
     proxyModel->selectedSection.clear();
 }
 
-void StringsWidget::stringSearchFinished(const QList<StringDescription> &strings)
+void StringsWidget::stringsFound(const QVector<ScannedString> &strings)
 {
-    model->beginResetModel();
-    this->strings = strings;
-    model->endResetModel();
-
+    model->appendStrings(strings);
     tree->showItemsNumber(proxyModel->rowCount());
-
-    task.clear();
 }
 
 void StringsWidget::on_actionCopy()
@@ -10,6 +10,7 @@
 #include "AddressableItemModel.h"
 
 #include <QAbstractListModel>
+#include <QCache>
 #include <QSortFilterProxyModel>
 
 class MainWindow;
@@ -27,13 +28,20 @@ class StringsModel: public AddressableItemModel<QAbstractListModel>
     friend StringsWidget;
 
 private:
-    QList<StringDescription> *strings;
+    QSharedPointer<const StringsSource> source;
+    QVector<ScannedString> strings;
+    // recently decoded texts by row, filtering and sorting ask for the same rows repeatedly
+    static const int TEXT_CACHE_SIZE = 10000;
+    mutable QCache<int, QString> texts;
 
 public:
     enum Column { OffsetColumn = 0, StringColumn, TypeColumn, LengthColumn, SizeColumn, SectionColumn, ColumnCount };
     static const int StringDescriptionRole = Qt::UserRole;
 
-    StringsModel(QList<StringDescription> *strings, QObject *parent = nullptr);
+    StringsModel(QObject *parent = nullptr);
+
+    void reset(QSharedPointer<const StringsSource> source);
+    void appendStrings(const QVector<ScannedString> &newStrings);
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -43,7 +51,9 @@ public:
                         int role = Qt::DisplayRole) const override;
 
     RVA address(const QModelIndex &index) const override;
-    const StringDescription *description(const QModelIndex &index) const;
+    const ScannedString &string(const QModelIndex &index) const;
+    QString text(int row) const;
+    const StringsSource *getSource() const     { return source.data(); }
 };
 
 
@@ -75,7 +85,7 @@ public:
 
 private slots:
     void refreshStrings();
-    void stringSearchFinished(const QList<StringDescription> &strings);
+    void stringsFound(const QVector<ScannedString> &strings);
     void refreshSectionCombo();
 
     void on_actionCopy();
@@ -87,7 +97,6 @@ private:
 
     StringsModel *model;
     StringsProxyModel *proxyModel;
-    QList<StringDescription> strings;
     CutterTreeWidget *tree;
 };
 